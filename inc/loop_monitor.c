@@ -0,0 +1,115 @@
+#include <string.h>
+#include "hardware/watchdog.h"
+#include "loop_monitor.h"
+
+// Faixa log2 de uma duração: 0 para < 2 us, k para [2^k, 2^(k+1)) us
+uint8_t loop_monitor_bucket(uint32_t us) {
+    uint8_t k = 0;
+    while (us > 1 && k < LOOP_MON_BUCKETS - 1) {
+        us >>= 1;
+        k++;
+    }
+    return k;
+}
+
+void loop_monitor_init(loop_monitor_t *m, uint32_t budget_us) {
+    memset(m, 0, sizeof(*m));
+    m->budget_us = budget_us;
+    m->stage = LOOP_MON_IDLE;
+    m->worst_stage = LOOP_MON_NONE;
+    m->last_overrun_stage = LOOP_MON_NONE;
+    m->reset_stage = LOOP_MON_NONE;
+}
+
+// Recupera o estágio gravado antes de um reset pelo watchdog e arma o watchdog.
+// A partir daqui o loop precisa chamar loop_monitor_pass a cada timeout_ms.
+void loop_monitor_arm_watchdog(loop_monitor_t *m, uint32_t timeout_ms) {
+    if (watchdog_enable_caused_reboot() &&
+        watchdog_hw->scratch[LOOP_MON_SCRATCH_MAGIC] == LOOP_MON_MAGIC) {
+        m->reset_stage = (uint8_t)watchdog_hw->scratch[LOOP_MON_SCRATCH_STAGE];
+        m->resets = watchdog_hw->scratch[LOOP_MON_SCRATCH_RESETS] + 1;
+    }
+    watchdog_hw->scratch[LOOP_MON_SCRATCH_MAGIC] = LOOP_MON_MAGIC;
+    watchdog_hw->scratch[LOOP_MON_SCRATCH_STAGE] = m->stage;
+    watchdog_hw->scratch[LOOP_MON_SCRATCH_RESETS] = m->resets;
+    watchdog_enable(timeout_ms, true); // Pausa durante depuração
+    m->watchdog = true;
+}
+
+// Início de uma passagem do loop principal: mede o período e alimenta o watchdog.
+// O sono à espera da próxima tarefa é descontado: o histograma mostra o custo do
+// loop e das tarefas, e não os intervalos ociosos.
+void loop_monitor_pass(loop_monitor_t *m, uint64_t now_us) {
+    if (m->has_pass) {
+        uint64_t period = now_us - m->last_pass_us;
+        period = period > m->pass_idle_us ? period - m->pass_idle_us : 0;
+        m->period_hist[loop_monitor_bucket(period > UINT32_MAX ? UINT32_MAX : (uint32_t)period)]++;
+    }
+    m->last_pass_us = now_us;
+    m->pass_idle_us = 0;
+    m->has_pass = true;
+    if (m->watchdog) {
+        watchdog_update();
+    }
+}
+
+// Marca o estágio em execução; fica no rascunho do watchdog caso ele trave
+void loop_monitor_stage_begin(loop_monitor_t *m, uint8_t stage) {
+    m->stage = stage;
+    if (m->watchdog) {
+        watchdog_hw->scratch[LOOP_MON_SCRATCH_STAGE] = stage;
+    }
+}
+
+// Fim de um estágio: registra o atraso de início e verifica o orçamento
+void loop_monitor_stage_end(loop_monitor_t *m, uint8_t stage, uint32_t late_us, uint32_t run_us) {
+    m->iterations++;
+    m->jitter_hist[loop_monitor_bucket(late_us)]++;
+    if (run_us > m->worst_us) {
+        m->worst_us = run_us;
+        m->worst_stage = stage;
+    }
+    if (run_us > m->budget_us) {
+        if (stage < LOOP_MON_STAGES) {
+            m->overruns[stage]++;
+        }
+        m->last_overrun_stage = stage;
+        m->last_overrun_us = run_us;
+    }
+    m->stage = LOOP_MON_IDLE;
+    if (m->watchdog) {
+        watchdog_hw->scratch[LOOP_MON_SCRATCH_STAGE] = LOOP_MON_IDLE;
+    }
+}
+
+// Contabiliza um período em que o núcleo dormiu esperando a próxima tarefa
+void loop_monitor_idle(loop_monitor_t *m, uint32_t slept_us, bool low_clock) {
+    m->idle_us += slept_us;
+    m->pass_idle_us += slept_us;
+    m->sleeps++;
+    if (low_clock) {
+        m->low_clock_us += slept_us;
+    }
+}
+
+// Zera histogramas e contadores de estouro (preserva a janela de utilização, o orçamento,
+// o watchdog e o motivo do último reset)
+void loop_monitor_reset_stats(loop_monitor_t *m) {
+    memset(m->period_hist, 0, sizeof(m->period_hist));
+    memset(m->jitter_hist, 0, sizeof(m->jitter_hist));
+    memset(m->overruns, 0, sizeof(m->overruns));
+    m->iterations = 0;
+    m->worst_us = 0;
+    m->worst_stage = LOOP_MON_NONE;
+    m->last_overrun_stage = LOOP_MON_NONE;
+    m->last_overrun_us = 0;
+    m->has_pass = false;
+}
+
+// Começa uma nova janela de utilização da CPU em now_us
+void loop_monitor_reset_idle(loop_monitor_t *m, uint64_t now_us) {
+    m->window_us = now_us;
+    m->idle_us = 0;
+    m->low_clock_us = 0;
+    m->sleeps = 0;
+}
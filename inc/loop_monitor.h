@@ -0,0 +1,53 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef loop_monitor_inc_h
+#define loop_monitor_inc_h
+
+#define LOOP_MON_BUCKETS 20        // Faixas log2 em us: <2, 2-3, 4-7, ..., >= 2^19
+#define LOOP_MON_STAGES 16         // Estágios identificáveis (ids de tarefa do escalonador)
+#define LOOP_MON_IDLE 0xFE         // Estágio: loop principal, fora de tarefas
+#define LOOP_MON_NONE 0xFF         // Nenhum estágio registrado
+
+// Registradores de rascunho do watchdog usados pelo monitor (0 a 3 são livres no SDK)
+#define LOOP_MON_SCRATCH_MAGIC 0
+#define LOOP_MON_SCRATCH_STAGE 1
+#define LOOP_MON_SCRATCH_RESETS 2
+#define LOOP_MON_MAGIC 0x4C4D4F4Eu // "LMON"
+
+typedef struct {
+    uint32_t period_hist[LOOP_MON_BUCKETS]; // Intervalo entre passagens do loop, sem o tempo dormindo
+    uint32_t jitter_hist[LOOP_MON_BUCKETS]; // Atraso entre liberação e início das tarefas
+    uint32_t budget_us;                     // Orçamento de uma iteração
+    uint32_t overruns[LOOP_MON_STAGES];     // Iterações acima do orçamento, por estágio
+    uint32_t iterations;
+    uint32_t worst_us;                      // Maior iteração observada
+    uint8_t worst_stage;
+    uint8_t last_overrun_stage;
+    uint32_t last_overrun_us;
+    uint64_t last_pass_us;
+    uint32_t pass_idle_us;                  // Tempo dormindo desde a última passagem
+    bool has_pass;
+    volatile uint8_t stage;                 // Estágio em execução
+    bool watchdog;                          // Watchdog armado
+    uint8_t reset_stage;                    // Estágio em execução no último reset pelo watchdog
+    uint32_t resets;                        // Resets consecutivos pelo watchdog
+
+    // Utilização da CPU desde o início da janela
+    uint64_t window_us;                     // Início da janela de medição
+    uint64_t idle_us;                       // Tempo dormindo à espera de eventos
+    uint64_t low_clock_us;                  // Parte do sono com clk_sys reduzido
+    uint32_t sleeps;                        // Vezes que o núcleo dormiu
+} loop_monitor_t;
+
+uint8_t loop_monitor_bucket(uint32_t us);
+void loop_monitor_init(loop_monitor_t *m, uint32_t budget_us);
+void loop_monitor_arm_watchdog(loop_monitor_t *m, uint32_t timeout_ms);
+void loop_monitor_pass(loop_monitor_t *m, uint64_t now_us);
+void loop_monitor_stage_begin(loop_monitor_t *m, uint8_t stage);
+void loop_monitor_stage_end(loop_monitor_t *m, uint8_t stage, uint32_t late_us, uint32_t run_us);
+void loop_monitor_idle(loop_monitor_t *m, uint32_t slept_us, bool low_clock);
+void loop_monitor_reset_stats(loop_monitor_t *m);
+void loop_monitor_reset_idle(loop_monitor_t *m, uint64_t now_us);
+
+#endif
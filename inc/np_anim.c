@@ -0,0 +1,130 @@
+#include <string.h>
+#include "np_anim.h"
+
+// Inicializa uma linha do tempo vazia para uma matriz width x height
+void npAnimInit(np_anim_t *anim, uint8_t width, uint8_t height, bool loop) {
+    memset(anim, 0, sizeof(*anim));
+    anim->width = width;
+    anim->height = height;
+    anim->loop = loop;
+}
+
+// Acrescenta um quadro-chave; retorna false se a linha do tempo estiver cheia
+bool npAnimAddKeyframe(np_anim_t *anim, const uint8_t *pattern, uint16_t duration_ms,
+                       np_transition_t transition, uint16_t transition_ms) {
+    if (anim->count >= NP_ANIM_MAX_KEYFRAMES || duration_ms == 0) {
+        return false;
+    }
+    if (transition_ms > duration_ms) {
+        transition_ms = duration_ms;
+    }
+    np_keyframe_t *key = &anim->keys[anim->count++];
+    key->pattern = pattern;
+    key->duration_ms = duration_ms;
+    key->transition = transition;
+    key->transition_ms = transition_ms;
+    return true;
+}
+
+// Reinicia a linha do tempo a partir do primeiro quadro-chave
+void npAnimStart(np_anim_t *anim) {
+    if (anim->count == 0) {
+        return;
+    }
+    anim->current = 0;
+    anim->elapsed_us = 0;
+    anim->running = true;
+}
+
+void npAnimStop(np_anim_t *anim) {
+    anim->running = false;
+}
+
+// Avança o relógio da animação; retorna false quando uma linha do tempo sem repetição termina
+bool npAnimAdvance(np_anim_t *anim, uint32_t dt_us) {
+    if (!anim->running) {
+        return false;
+    }
+    anim->elapsed_us += dt_us;
+    while (anim->elapsed_us >= anim->keys[anim->current].duration_ms * 1000u) {
+        anim->elapsed_us -= anim->keys[anim->current].duration_ms * 1000u;
+        if (anim->current + 1 < anim->count) {
+            anim->current++;
+        } else if (anim->loop) {
+            anim->current = 0;
+        } else {
+            // Mantém o último quadro-chave estável na tela
+            anim->elapsed_us = anim->keys[anim->current].duration_ms * 1000u;
+            anim->running = false;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Gera o quadro atual (largura * altura * 3 bytes RGB) com interpolação em ponto fixo Q8
+void npAnimRender(const np_anim_t *anim, uint8_t *rgb) {
+    const int size = anim->width * anim->height * 3;
+    if (anim->count == 0) {
+        memset(rgb, 0, size);
+        return;
+    }
+
+    const np_keyframe_t *key = &anim->keys[anim->current];
+    uint32_t elapsed_ms = anim->elapsed_us / 1000;
+
+    // Fora da transição o padrão é copiado diretamente
+    if (key->transition == NP_TRANS_NONE || elapsed_ms >= key->transition_ms) {
+        memcpy(rgb, key->pattern, size);
+        return;
+    }
+
+    // Padrão de origem: quadro-chave anterior, ou apagado no início sem repetição
+    const uint8_t *from = NULL;
+    if (anim->current > 0) {
+        from = anim->keys[anim->current - 1].pattern;
+    } else if (anim->loop) {
+        from = anim->keys[anim->count - 1].pattern;
+    }
+
+    uint32_t alpha = (elapsed_ms << 8) / key->transition_ms; // 0..255
+
+    switch (key->transition) {
+        case NP_TRANS_FADE:
+            for (int i = 0; i < size; i++) {
+                int a = from ? from[i] : 0;
+                int b = key->pattern[i];
+                rgb[i] = (uint8_t)(a + (((b - a) * (int)alpha) >> 8));
+            }
+            break;
+        case NP_TRANS_SLIDE: {
+            int shift = (int)((alpha * anim->width) >> 8); // Colunas já deslocadas
+            for (int y = 0; y < anim->height; y++) {
+                for (int x = 0; x < anim->width; x++) {
+                    int src = x + shift;
+                    uint8_t *out = &rgb[(y * anim->width + x) * 3];
+                    if (src < anim->width) {
+                        if (from) {
+                            memcpy(out, &from[(y * anim->width + src) * 3], 3);
+                        } else {
+                            memset(out, 0, 3);
+                        }
+                    } else {
+                        memcpy(out, &key->pattern[(y * anim->width + src - anim->width) * 3], 3);
+                    }
+                }
+            }
+            break;
+        }
+        case NP_TRANS_BLINK:
+            if ((elapsed_ms / NP_ANIM_BLINK_MS) % 2 == 0) {
+                memcpy(rgb, key->pattern, size);
+            } else {
+                memset(rgb, 0, size);
+            }
+            break;
+        default:
+            memcpy(rgb, key->pattern, size);
+            break;
+    }
+}
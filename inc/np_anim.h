@@ -0,0 +1,47 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef np_anim_inc_h
+#define np_anim_inc_h
+
+#define NP_ANIM_FPS 30                         // Taxa fixa de quadros da animação
+#define NP_ANIM_FRAME_US (1000000 / NP_ANIM_FPS) // Período de um quadro em microssegundos
+#define NP_ANIM_MAX_KEYFRAMES 8                // Quadros-chave por linha do tempo
+#define NP_ANIM_BLINK_MS 100                   // Meio período da transição de piscar
+
+// Transição usada ao entrar em um quadro-chave
+typedef enum {
+    NP_TRANS_NONE,  // Troca imediata
+    NP_TRANS_FADE,  // Mistura linear entre o padrão anterior e o novo
+    NP_TRANS_SLIDE, // Novo padrão entra pela direita empurrando o anterior
+    NP_TRANS_BLINK  // Novo padrão pisca durante a transição
+} np_transition_t;
+
+// Quadro-chave: padrão RGB (largura * altura * 3 bytes, linha a linha) e tempos
+typedef struct {
+    const uint8_t *pattern;
+    uint16_t duration_ms;   // Tempo total no quadro-chave, incluindo a transição
+    uint16_t transition_ms; // Duração da transição a partir do quadro anterior
+    np_transition_t transition;
+} np_keyframe_t;
+
+// Linha do tempo de quadros-chave
+typedef struct {
+    np_keyframe_t keys[NP_ANIM_MAX_KEYFRAMES];
+    uint8_t count;
+    uint8_t current;
+    uint8_t width, height;
+    bool loop;
+    volatile bool running;
+    uint32_t elapsed_us;    // Tempo decorrido dentro do quadro-chave atual
+} np_anim_t;
+
+void npAnimInit(np_anim_t *anim, uint8_t width, uint8_t height, bool loop);
+bool npAnimAddKeyframe(np_anim_t *anim, const uint8_t *pattern, uint16_t duration_ms,
+                       np_transition_t transition, uint16_t transition_ms);
+void npAnimStart(np_anim_t *anim);
+void npAnimStop(np_anim_t *anim);
+bool npAnimAdvance(np_anim_t *anim, uint32_t dt_us);
+void npAnimRender(const np_anim_t *anim, uint8_t *rgb);
+
+#endif
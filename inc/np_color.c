@@ -0,0 +1,114 @@
+#include "np_color.h"
+
+// Curva gamma 2.2 em ponto fixo 8.8: entrada de 8 bits, saída de 0 a 255 * 256.
+// A parte fracionária alimenta o dithering temporal.
+static const uint16_t gamma_8_8[256] = {
+        0,     0,     2,     4,     7,    11,    17,    24,
+       32,    42,    53,    65,    78,    94,   110,   128,
+      148,   169,   191,   216,   241,   269,   298,   328,
+      360,   394,   430,   467,   506,   547,   589,   633,
+      679,   726,   776,   827,   880,   934,   991,  1049,
+     1109,  1171,  1235,  1300,  1368,  1437,  1508,  1581,
+     1656,  1733,  1812,  1893,  1975,  2060,  2146,  2235,
+     2325,  2417,  2512,  2608,  2706,  2806,  2908,  3013,
+     3119,  3227,  3337,  3450,  3564,  3680,  3798,  3919,
+     4041,  4166,  4292,  4421,  4552,  4685,  4819,  4956,
+     5096,  5237,  5380,  5525,  5673,  5823,  5974,  6128,
+     6284,  6442,  6603,  6765,  6930,  7097,  7266,  7437,
+     7610,  7786,  7963,  8143,  8325,  8509,  8696,  8885,
+     9075,  9268,  9464,  9661,  9861, 10063, 10267, 10474,
+    10682, 10893, 11107, 11322, 11540, 11760, 11982, 12207,
+    12433, 12663, 12894, 13128, 13363, 13602, 13842, 14085,
+    14330, 14578, 14827, 15080, 15334, 15591, 15850, 16111,
+    16375, 16641, 16909, 17180, 17453, 17729, 18006, 18287,
+    18569, 18854, 19141, 19431, 19723, 20017, 20314, 20613,
+    20915, 21218, 21525, 21833, 22144, 22458, 22774, 23092,
+    23413, 23736, 24062, 24390, 24720, 25053, 25388, 25726,
+    26066, 26408, 26753, 27101, 27451, 27803, 28158, 28515,
+    28875, 29237, 29602, 29969, 30338, 30710, 31085, 31462,
+    31841, 32223, 32608, 32995, 33384, 33776, 34170, 34567,
+    34967, 35369, 35773, 36180, 36589, 37001, 37416, 37833,
+    38252, 38674, 39099, 39526, 39956, 40388, 40823, 41260,
+    41700, 42142, 42587, 43034, 43484, 43937, 44392, 44849,
+    45310, 45772, 46238, 46706, 47176, 47649, 48125, 48603,
+    49084, 49567, 50053, 50542, 51033, 51526, 52023, 52522,
+    53023, 53527, 54034, 54543, 55055, 55570, 56087, 56607,
+    57129, 57654, 58182, 58712, 59245, 59780, 60318, 60859,
+    61402, 61948, 62497, 63048, 63602, 64159, 64718, 65280,
+};
+
+// Tabela combinada gamma * brilho, reconstruída apenas quando o brilho muda
+static uint16_t color_lut[256];
+static uint8_t color_brightness = NP_BRIGHTNESS_DEFAULT;
+static bool color_dither = true;
+
+// Recalcula a tabela combinada para o brilho atual
+static void npColorBuildLut() {
+    for (int i = 0; i < 256; i++) {
+        color_lut[i] = (uint16_t)(((uint32_t)gamma_8_8[i] * color_brightness) / 255);
+    }
+}
+
+// Inicializa o pipeline de cor com o brilho padrão
+void npColorInit() {
+    npColorBuildLut();
+}
+
+// Define o brilho global (0 apaga a matriz, 255 é o brilho máximo)
+void npColorSetBrightness(uint8_t brightness) {
+    if (brightness == color_brightness) {
+        return;
+    }
+    color_brightness = brightness;
+    npColorBuildLut();
+}
+
+uint8_t npColorGetBrightness() {
+    return color_brightness;
+}
+
+// Converte uma leitura de 12 bits do sensor de luz ambiente em brilho global
+void npColorSetAmbient(uint16_t adc_12bits) {
+    if (adc_12bits > 4095) {
+        adc_12bits = 4095;
+    }
+    uint32_t range = NP_BRIGHTNESS_MAX - NP_BRIGHTNESS_MIN;
+    npColorSetBrightness((uint8_t)(NP_BRIGHTNESS_MIN + (range * adc_12bits) / 4095));
+}
+
+// Ativa ou desativa o dithering temporal
+void npColorSetDither(bool enabled) {
+    color_dither = enabled;
+}
+
+// Aplica gamma, brilho e dithering a um quadro inteiro e gera as palavras do PIO.
+// Cada palavra leva G, R e B nos bits 31..8, na ordem em que são transmitidos.
+// O vetor dither guarda o resto fracionário de cada canal entre um quadro e outro.
+// Retorna quantos quadros iguais fecham um ciclo do dithering (0 se não há fração):
+// depois disso os restos voltam ao início e reenviar o quadro não muda mais a média.
+unsigned npColorEncode(const pixel_t *pixels, uint32_t *words, uint8_t *dither, unsigned count) {
+    uint32_t fracao = 0;
+    for (unsigned i = 0; i < count; i++) {
+        const uint8_t channels[3] = {pixels[i].G, pixels[i].R, pixels[i].B};
+        uint32_t word = 0;
+        for (int ch = 0; ch < 3; ch++) {
+            uint32_t value = color_lut[channels[ch]];
+            fracao |= value & 0xFF;
+            if (color_dither) {
+                value += dither[i * 3 + ch];
+                dither[i * 3 + ch] = (uint8_t)value; // Guarda a fração para o próximo quadro
+            }
+            uint32_t out = value >> 8;
+            if (out > 255) {
+                out = 255;
+            }
+            word = (word << 8) | out;
+        }
+        words[i] = word << 8;
+    }
+    if (!color_dither || fracao == 0) {
+        return 0;
+    }
+    // O ciclo de um resto f é 256 / mdc(f, 256); o menor bit presente dá o ciclo do quadro
+    return 256u / (fracao & -fracao);
+}
@@ -0,0 +1,24 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef np_color_inc_h
+#define np_color_inc_h
+
+#define NP_BRIGHTNESS_DEFAULT 128 // Brilho global inicial (0-255)
+#define NP_BRIGHTNESS_MIN 8       // Brilho mínimo quando controlado pelo sensor de luz ambiente
+#define NP_BRIGHTNESS_MAX 255     // Brilho máximo quando controlado pelo sensor de luz ambiente
+
+// Estrutura para representar um pixel RGB na matriz de LEDs (ordem do fio: G, R, B)
+struct pixel_t {
+    uint8_t G, R, B;           // Componentes verde, vermelho e azul
+};
+typedef struct pixel_t pixel_t;
+
+void npColorInit();
+void npColorSetBrightness(uint8_t brightness);
+uint8_t npColorGetBrightness();
+void npColorSetAmbient(uint16_t adc_12bits);
+void npColorSetDither(bool enabled);
+unsigned npColorEncode(const pixel_t *pixels, uint32_t *words, uint8_t *dither, unsigned count);
+
+#endif
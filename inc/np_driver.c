@@ -0,0 +1,102 @@
+#include "hardware/dma.h"
+#include "ws2818b.pio.h"
+#include "np_driver.h"
+
+// Offset do programa em cada PIO (-1 enquanto não carregado)
+static int program_offset[2] = {-1, -1};
+
+// Reserva uma máquina de estado, preferindo pio0 e recorrendo ao pio1
+static bool npDriverClaimSm(np_strip_t *strip) {
+    PIO pios[2] = {pio0, pio1};
+    for (int i = 0; i < 2; i++) {
+        int sm = pio_claim_unused_sm(pios[i], false);
+        if (sm < 0) {
+            continue;
+        }
+        if (program_offset[i] < 0) {
+            program_offset[i] = pio_add_program(pios[i], &ws2818b_program); // Carrega programa PIO
+        }
+        strip->pio = pios[i];
+        strip->sm = (uint)sm;
+        ws2818b_program_init(strip->pio, strip->sm, program_offset[i], strip->pin, NP_FREQ_HZ);
+        return true;
+    }
+    return false;
+}
+
+// Divide a cadeia de LEDs entre as fitas e configura um PIO + DMA por fita.
+// Fitas que ficariam sem LEDs não reservam recursos. Retorna false se faltar máquina
+// de estado ou canal DMA; nesse caso só as fitas já configuradas são transmitidas.
+bool npDriverInit(np_driver_t *drv, const uint *pins, uint n_strips, const uint32_t *words, uint led_count) {
+    if (n_strips > NP_MAX_STRIPS) {
+        n_strips = NP_MAX_STRIPS;
+    }
+    drv->n_strips = 0;
+    drv->led_count = led_count;
+    drv->words = words;
+    drv->dma_mask = 0;
+    drv->free_at = 0;
+
+    uint per_strip = (led_count + n_strips - 1) / n_strips;
+    drv->longest = per_strip;
+
+    for (uint s = 0; s < n_strips; s++) {
+        np_strip_t *strip = &drv->strips[s];
+        strip->pin = pins[s];
+        strip->first = s * per_strip;
+        if (strip->first >= led_count) {
+            break; // Mais fitas que LEDs: esta e as seguintes ficam vazias
+        }
+        strip->count = (strip->first + per_strip <= led_count) ? per_strip : led_count - strip->first;
+        if (!npDriverClaimSm(strip)) {
+            return false;
+        }
+
+        // Canal DMA: memória -> FIFO TX do PIO, no ritmo pedido pela máquina de estado
+        int dma = dma_claim_unused_channel(false);
+        if (dma < 0) {
+            pio_sm_unclaim(strip->pio, strip->sm);
+            return false;
+        }
+        strip->dma = (uint)dma;
+        dma_channel_config cfg = dma_channel_get_default_config(strip->dma);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_dreq(&cfg, pio_get_dreq(strip->pio, strip->sm, true));
+        dma_channel_configure(strip->dma, &cfg, &strip->pio->txf[strip->sm],
+                              &words[strip->first], strip->count, false);
+        drv->dma_mask |= 1u << strip->dma;
+        drv->n_strips = s + 1;
+    }
+    return true;
+}
+
+// Indica se algum quadro ainda está sendo transmitido ou travando
+bool npDriverBusy(const np_driver_t *drv) {
+    for (uint s = 0; s < drv->n_strips; s++) {
+        if (dma_channel_is_busy(drv->strips[s].dma)) {
+            return true;
+        }
+    }
+    return time_us_64() < drv->free_at;
+}
+
+// Espera o quadro anterior terminar de travar
+void npDriverWait(const np_driver_t *drv) {
+    while (npDriverBusy(drv)) {
+        tight_loop_contents();
+    }
+}
+
+// Dispara todas as fitas ao mesmo tempo: o tempo de atualização depende
+// apenas da maior fita, e não do total de LEDs
+void npDriverStart(np_driver_t *drv) {
+    for (uint s = 0; s < drv->n_strips; s++) {
+        np_strip_t *strip = &drv->strips[s];
+        dma_channel_set_read_addr(strip->dma, &drv->words[strip->first], false);
+        dma_channel_set_trans_count(strip->dma, strip->count, false);
+    }
+    dma_start_channel_mask(drv->dma_mask);
+    drv->free_at = time_us_64() + drv->longest * NP_LED_US + NP_RESET_US;
+}
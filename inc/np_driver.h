@@ -0,0 +1,38 @@
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+#ifndef np_driver_inc_h
+#define np_driver_inc_h
+
+#define NP_MAX_STRIPS 4        // Fitas transmitidas em paralelo
+#define NP_FREQ_HZ 800000.f    // Frequência de bits do WS2812B
+#define NP_LED_US 30           // Tempo no fio por LED (24 bits a 800 kHz)
+#define NP_RESET_US 100        // Tempo em nível baixo para a fita travar o quadro
+
+// Uma fita: máquina de estado do PIO, canal DMA e trecho da cadeia de LEDs
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint dma;
+    uint pin;
+    uint first;                // Primeiro LED da cadeia atendido por esta fita
+    uint count;                // Quantidade de LEDs nesta fita
+} np_strip_t;
+
+// Conjunto de fitas que compartilham um único quadro codificado
+typedef struct {
+    np_strip_t strips[NP_MAX_STRIPS];
+    uint n_strips;             // Fitas configuradas (com LEDs e recursos reservados)
+    uint led_count;
+    uint longest;              // Maior fita, define o tempo de transmissão
+    const uint32_t *words;     // Quadro codificado (uma palavra por LED)
+    uint32_t dma_mask;         // Canais DMA disparados juntos
+    uint64_t free_at;          // Instante em que o quadro anterior terminou de travar
+} np_driver_t;
+
+bool npDriverInit(np_driver_t *drv, const uint *pins, uint n_strips, const uint32_t *words, uint led_count);
+bool npDriverBusy(const np_driver_t *drv);
+void npDriverWait(const np_driver_t *drv);
+void npDriverStart(np_driver_t *drv);
+
+#endif
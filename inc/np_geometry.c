@@ -0,0 +1,51 @@
+#include "np_geometry.h"
+
+// Largura total da matriz em LEDs
+uint16_t npGeometryWidth(const np_geometry_t *geo) {
+    return geo->panel_width * geo->tiles_x;
+}
+
+// Altura total da matriz em LEDs
+uint16_t npGeometryHeight(const np_geometry_t *geo) {
+    return geo->panel_height * geo->tiles_y;
+}
+
+// Número total de LEDs da matriz
+uint32_t npGeometryCount(const np_geometry_t *geo) {
+    return (uint32_t)npGeometryWidth(geo) * npGeometryHeight(geo);
+}
+
+// Converte coordenadas lógicas (x para a direita, y para baixo) na posição do LED
+// na cadeia; retorna -1 para coordenadas fora da matriz
+int npGeometryIndex(const np_geometry_t *geo, int x, int y) {
+    const int w = geo->panel_width;
+    const int h = geo->panel_height;
+    if (x < 0 || y < 0 || x >= w * geo->tiles_x || y >= h * geo->tiles_y) {
+        return -1;
+    }
+
+    // Painel que contém o pixel e sua posição na cadeia de painéis
+    int tx = x / w;
+    int ty = y / h;
+    if (geo->tile_serpentine && (ty % 2)) {
+        tx = geo->tiles_x - 1 - tx;
+    }
+    int tile = ty * geo->tiles_x + tx;
+
+    // Coordenadas locais, rotacionadas para a montagem física do painel
+    int lx = x % w;
+    int ly = y % h;
+    int px, py, pw;
+    switch (geo->rotation) {
+        case NP_ROT_90:  px = h - 1 - ly; py = lx;         pw = h; break;
+        case NP_ROT_180: px = w - 1 - lx; py = h - 1 - ly; pw = w; break;
+        case NP_ROT_270: px = ly;         py = w - 1 - lx; pw = h; break;
+        default:         px = lx;         py = ly;         pw = w; break;
+    }
+
+    // Linhas ímpares invertidas no cabeamento em serpentina
+    if (geo->serpentine && (py % 2)) {
+        px = pw - 1 - px;
+    }
+    return tile * w * h + py * pw + px;
+}
@@ -0,0 +1,31 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef np_geometry_inc_h
+#define np_geometry_inc_h
+
+// Rotação (sentido horário) com que cada painel foi montado
+typedef enum {
+    NP_ROT_0,
+    NP_ROT_90,
+    NP_ROT_180,
+    NP_ROT_270
+} np_rotation_t;
+
+// Geometria da matriz: painéis iguais encadeados em uma grade tiles_x x tiles_y
+typedef struct {
+    uint16_t panel_width;   // Colunas lógicas de cada painel
+    uint16_t panel_height;  // Linhas lógicas de cada painel
+    uint8_t tiles_x;        // Painéis na horizontal
+    uint8_t tiles_y;        // Painéis na vertical
+    bool serpentine;        // Linhas alternadas invertidas dentro do painel
+    bool tile_serpentine;   // Fileiras de painéis alternadas invertidas
+    np_rotation_t rotation; // Rotação de montagem de cada painel
+} np_geometry_t;
+
+uint16_t npGeometryWidth(const np_geometry_t *geo);
+uint16_t npGeometryHeight(const np_geometry_t *geo);
+uint32_t npGeometryCount(const np_geometry_t *geo);
+int npGeometryIndex(const np_geometry_t *geo, int x, int y);
+
+#endif
@@ -0,0 +1,127 @@
+#include <string.h>
+#include "route_table.h"
+
+_Static_assert(sizeof(route_header_t) == 12, "cabeçalho da tabela deve ter 12 bytes");
+_Static_assert(sizeof(route_stop_t) == 24, "registro de parada deve ter 24 bytes");
+
+// CRC-32 (polinômio refletido 0xEDB88320), sem tabela para não ocupar RAM
+uint32_t route_crc32(const uint8_t *p, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+size_t route_image_len(uint16_t count) {
+    return sizeof(route_header_t) + (size_t)count * sizeof(route_stop_t);
+}
+
+// Ativa uma tabela já em memória; exige ao menos uma parada e distâncias crescentes
+bool route_use(route_t *r, const route_stop_t *stops, uint16_t count) {
+    if (count == 0 || count > ROUTE_MAX_STOPS) {
+        return false;
+    }
+    for (uint16_t i = 1; i < count; i++) {
+        if (stops[i].distance_m <= stops[i - 1].distance_m ||
+            stops[i].offset_s < stops[i - 1].offset_s) {
+            return false;
+        }
+    }
+    r->stops = stops;
+    r->count = count;
+    return true;
+}
+
+// Valida uma imagem (magic, versão, tamanho, CRC e ordenação) e a ativa sem copiá-la
+bool route_open(route_t *r, const uint8_t *image, size_t len) {
+    const route_header_t *h = (const route_header_t *)image;
+    if (len < sizeof(route_header_t) || h->magic != ROUTE_MAGIC || h->version != ROUTE_VERSION ||
+        h->count == 0 || h->count > ROUTE_MAX_STOPS || route_image_len(h->count) > len) {
+        return false;
+    }
+    const uint8_t *stops = image + sizeof(route_header_t);
+    if (route_crc32(stops, (size_t)h->count * sizeof(route_stop_t)) != h->crc) {
+        return false;
+    }
+    return route_use(r, (const route_stop_t *)stops, h->count);
+}
+
+uint32_t route_length_m(const route_t *r) {
+    return r->stops[r->count - 1].distance_m;
+}
+
+// Busca binária: última parada com distância <= distance_m (0 antes da origem)
+uint16_t route_find(const route_t *r, uint32_t distance_m) {
+    uint16_t lo = 0, hi = r->count;
+    while (hi - lo > 1) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (r->stops[mid].distance_m <= distance_m) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Paradas anterior e seguinte e tempos programados, interpolando no trecho atual
+void route_locate(const route_t *r, uint32_t distance_m, route_position_t *pos) {
+    uint16_t prev = route_find(r, distance_m);
+    const route_stop_t *a = &r->stops[prev];
+    const route_stop_t *end = &r->stops[r->count - 1];
+    pos->prev = prev;
+    if (prev + 1 >= r->count || distance_m < a->distance_m) {
+        // Terminal alcançado (ou antes da origem): a parada de referência é a própria
+        pos->next = prev;
+        pos->to_next_m = distance_m < a->distance_m ? a->distance_m - distance_m : 0;
+        pos->eta_next_s = 0;
+        pos->eta_end_s = end->offset_s - a->offset_s;
+        return;
+    }
+    const route_stop_t *b = &r->stops[prev + 1];
+    uint32_t segment_m = b->distance_m - a->distance_m;
+    uint32_t to_next_m = b->distance_m - distance_m;
+    uint32_t eta_next = (uint32_t)(((uint64_t)(b->offset_s - a->offset_s) * to_next_m + segment_m / 2) / segment_m);
+    pos->next = (uint16_t)(prev + 1);
+    pos->to_next_m = to_next_m;
+    pos->eta_next_s = eta_next;
+    pos->eta_end_s = eta_next + (end->offset_s - b->offset_s);
+}
+
+void route_loader_begin(route_loader_t *l, route_program_fn program) {
+    memset(l->page, 0xFF, sizeof(l->page));
+    l->received = 0;
+    l->expected = 0;
+    l->program = program;
+}
+
+// Acrescenta um byte da imagem; cada página completa é gravada na hora, e a última
+// é completada com 0xFF. A validação final (CRC) cabe a route_open sobre a flash.
+int route_loader_feed(route_loader_t *l, uint8_t byte) {
+    if (l->expected && l->received >= l->expected) {
+        return ROUTE_LOAD_DONE;
+    }
+    size_t pos = l->received % ROUTE_PAGE_LEN;
+    l->page[pos] = byte;
+    l->received++;
+
+    if (l->received == sizeof(route_header_t)) {
+        route_header_t h;
+        memcpy(&h, l->page, sizeof(h));
+        if (h.magic != ROUTE_MAGIC || h.version != ROUTE_VERSION || h.count == 0 || h.count > ROUTE_MAX_STOPS) {
+            return ROUTE_LOAD_ERROR;
+        }
+        l->expected = route_image_len(h.count);
+    }
+
+    bool done = l->expected && l->received == l->expected;
+    if (pos == ROUTE_PAGE_LEN - 1 || done) {
+        l->program((uint32_t)(l->received - 1 - pos), l->page);
+        memset(l->page, 0xFF, sizeof(l->page));
+    }
+    return done ? ROUTE_LOAD_DONE : ROUTE_LOAD_MORE;
+}
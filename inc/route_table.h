@@ -0,0 +1,76 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef route_table_inc_h
+#define route_table_inc_h
+
+// Imagem da tabela (little-endian), gravada num setor de flash ou const no firmware:
+//   cabeçalho route_header_t seguido de count registros route_stop_t,
+//   ordenados por distância acumulada crescente
+#define ROUTE_MAGIC 0x41544F52u        // "ROTA"
+#define ROUTE_VERSION 1
+#define ROUTE_NAME_LEN 16              // Nome da parada, com '\0' se menor
+#define ROUTE_IMAGE_MAX 4096           // Um setor de flash
+#define ROUTE_PAGE_LEN 256             // Página de gravação da flash
+#define ROUTE_MAX_STOPS ((ROUTE_IMAGE_MAX - sizeof(route_header_t)) / sizeof(route_stop_t))
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t count;
+    uint32_t crc;                      // CRC-32 dos registros de paradas
+} route_header_t;
+
+typedef struct {
+    char name[ROUTE_NAME_LEN];
+    uint32_t distance_m;               // Distância acumulada desde a origem
+    uint16_t offset_s;                 // Horário programado relativo à partida
+    uint8_t glyph;                     // Padrão da matriz de LEDs para a parada
+    uint8_t reserved;
+} route_stop_t;
+
+// Visão da tabela ativa: só ponteiros, as paradas ficam na flash
+typedef struct {
+    const route_stop_t *stops;
+    uint16_t count;
+} route_t;
+
+// Posição na linha para uma distância percorrida
+typedef struct {
+    uint16_t prev;                     // Última parada alcançada
+    uint16_t next;                     // Próxima parada (igual a prev no terminal)
+    uint32_t to_next_m;                // Distância até a próxima parada
+    uint32_t eta_next_s;               // Tempo programado até a próxima parada
+    uint32_t eta_end_s;                // Tempo programado até o terminal
+} route_position_t;
+
+// Carregamento de uma imagem recebida byte a byte, gravada uma página por vez
+typedef void (*route_program_fn)(uint32_t offset, const uint8_t *page);
+
+typedef struct {
+    uint8_t page[ROUTE_PAGE_LEN];      // Página em montagem
+    size_t received;                   // Bytes da imagem recebidos
+    size_t expected;                   // Tamanho da imagem (conhecido após o cabeçalho)
+    route_program_fn program;
+} route_loader_t;
+
+enum {
+    ROUTE_LOAD_MORE,                   // Aguardando mais bytes
+    ROUTE_LOAD_DONE,                   // Imagem completa e gravada
+    ROUTE_LOAD_ERROR                   // Cabeçalho inválido
+};
+
+uint32_t route_crc32(const uint8_t *p, size_t len);
+bool route_use(route_t *r, const route_stop_t *stops, uint16_t count);
+bool route_open(route_t *r, const uint8_t *image, size_t len);
+size_t route_image_len(uint16_t count);
+uint32_t route_length_m(const route_t *r);
+uint16_t route_find(const route_t *r, uint32_t distance_m);
+void route_locate(const route_t *r, uint32_t distance_m, route_position_t *pos);
+
+void route_loader_begin(route_loader_t *l, route_program_fn program);
+int route_loader_feed(route_loader_t *l, uint8_t byte);
+
+#endif
@@ -0,0 +1,158 @@
+#include <string.h>
+#include "scheduler.h"
+
+// Inicializa o escalonador com a fonte de tempo em microssegundos
+void sched_init(sched_t *s, uint64_t (*now_us)(void)) {
+    memset(s, 0, sizeof(*s));
+    s->now_us = now_us;
+}
+
+// Registra ganchos chamados antes e depois de cada tarefa (NULL desativa)
+void sched_set_hooks(sched_t *s, sched_start_hook_t on_start, sched_end_hook_t on_end, void *ctx) {
+    s->on_start = on_start;
+    s->on_end = on_end;
+    s->hook_ctx = ctx;
+}
+
+static uint8_t sched_add(sched_t *s, const char *name, sched_fn_t fn, void *arg,
+                         uint32_t period_us, uint32_t deadline_us, uint8_t priority) {
+    if (s->count >= SCHED_MAX_TASKS) {
+        return SCHED_NO_TASK;
+    }
+    uint8_t id = s->count++;
+    sched_task_t *t = &s->tasks[id];
+    memset(t, 0, sizeof(*t));
+    t->name = name;
+    t->fn = fn;
+    t->arg = arg;
+    t->period_us = period_us;
+    t->deadline_us = deadline_us;
+    t->priority = priority;
+    return id;
+}
+
+// Registra uma tarefa periódica, liberada imediatamente
+uint8_t sched_add_periodic(sched_t *s, const char *name, sched_fn_t fn, void *arg,
+                           uint32_t period_us, uint32_t deadline_us, uint8_t priority) {
+    uint8_t id = sched_add(s, name, fn, arg, period_us, deadline_us, priority);
+    if (id != SCHED_NO_TASK) {
+        s->tasks[id].active = true;
+        s->tasks[id].release_us = s->now_us();
+    }
+    return id;
+}
+
+// Registra uma tarefa de disparo único, inativa até sched_trigger
+uint8_t sched_add_oneshot(sched_t *s, const char *name, sched_fn_t fn, void *arg,
+                          uint32_t deadline_us, uint8_t priority) {
+    return sched_add(s, name, fn, arg, 0, deadline_us, priority);
+}
+
+// (Re)agenda uma tarefa para daqui a delay_us
+void sched_trigger(sched_t *s, uint8_t id, uint32_t delay_us) {
+    if (id >= s->count) {
+        return;
+    }
+    s->tasks[id].release_us = s->now_us() + delay_us;
+    s->tasks[id].active = true;
+    s->tasks[id].triggered = true;
+}
+
+void sched_cancel(sched_t *s, uint8_t id) {
+    if (id < s->count) {
+        s->tasks[id].active = false;
+    }
+}
+
+// Altera o período de uma tarefa periódica; vale a partir da próxima liberação
+void sched_set_period(sched_t *s, uint8_t id, uint32_t period_us) {
+    if (id < s->count && s->tasks[id].period_us > 0 && period_us > 0) {
+        s->tasks[id].period_us = period_us;
+    }
+}
+
+// Executa a tarefa liberada mais urgente: maior prioridade e, em caso de empate,
+// prazo absoluto mais cedo. Retorna false se nenhuma tarefa estava pronta.
+bool sched_run_once(sched_t *s) {
+    uint64_t now = s->now_us();
+    sched_task_t *best = NULL;
+    uint64_t best_deadline = 0;
+
+    for (uint8_t i = 0; i < s->count; i++) {
+        sched_task_t *t = &s->tasks[i];
+        if (!t->active || t->release_us > now) {
+            continue;
+        }
+        uint64_t deadline = t->release_us + t->deadline_us;
+        if (!best || t->priority > best->priority ||
+            (t->priority == best->priority && deadline < best_deadline)) {
+            best = t;
+            best_deadline = deadline;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+
+    uint64_t release = best->release_us;
+    best->triggered = false;
+    if (best->period_us == 0) {
+        best->active = false; // Desarma antes de rodar: a tarefa pode se reagendar
+    }
+
+    uint8_t id = (uint8_t)(best - s->tasks);
+    if (s->on_start) {
+        s->on_start(s->hook_ctx, id);
+    }
+    uint64_t start = s->now_us();
+    best->fn(best->arg);
+    uint64_t end = s->now_us();
+
+    uint32_t late = (uint32_t)(start - release);
+    uint32_t run = (uint32_t)(end - start);
+    best->runs++;
+    best->last_us = run;
+    best->total_us += run;
+    if (run > best->max_us) {
+        best->max_us = run;
+    }
+    if (late > best->max_late_us) {
+        best->max_late_us = late;
+    }
+    if (end > best_deadline) {
+        best->misses++;
+    }
+    if (s->on_end) {
+        s->on_end(s->hook_ctx, id, late, run);
+    }
+
+    if (best->period_us > 0 && !best->triggered) {
+        // Próxima liberação na grade do período; períodos perdidos não são acumulados.
+        // Um sched_trigger durante a execução (da própria tarefa ou de uma interrupção) prevalece.
+        best->release_us = release + best->period_us;
+        if (best->release_us < end) {
+            best->release_us = end;
+        }
+    }
+    return true;
+}
+
+// Instante da próxima liberação entre as tarefas ativas (UINT64_MAX se nenhuma)
+uint64_t sched_next_release(const sched_t *s) {
+    uint64_t next = UINT64_MAX;
+    for (uint8_t i = 0; i < s->count; i++) {
+        if (s->tasks[i].active && s->tasks[i].release_us < next) {
+            next = s->tasks[i].release_us;
+        }
+    }
+    return next;
+}
+
+// Zera as estatísticas de todas as tarefas
+void sched_reset_stats(sched_t *s) {
+    for (uint8_t i = 0; i < s->count; i++) {
+        sched_task_t *t = &s->tasks[i];
+        t->runs = t->misses = t->last_us = t->max_us = t->max_late_us = 0;
+        t->total_us = 0;
+    }
+}
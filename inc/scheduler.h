@@ -0,0 +1,58 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef scheduler_inc_h
+#define scheduler_inc_h
+
+#define SCHED_MAX_TASKS 12     // Tarefas registradas no escalonador
+#define SCHED_NO_TASK 0xFF     // Retorno de erro ao registrar tarefa
+
+typedef void (*sched_fn_t)(void *arg);
+// Ganchos chamados em volta de cada execução (ex.: monitor do loop)
+typedef void (*sched_start_hook_t)(void *ctx, uint8_t id);
+typedef void (*sched_end_hook_t)(void *ctx, uint8_t id, uint32_t late_us, uint32_t run_us);
+
+// Tarefa cooperativa: roda até o fim, sem preempção
+typedef struct {
+    const char *name;
+    sched_fn_t fn;
+    void *arg;
+    uint32_t period_us;        // 0 para tarefas de disparo único
+    uint32_t deadline_us;      // Prazo relativo à liberação
+    uint8_t priority;          // Maior valor = mais urgente
+    bool active;
+    bool triggered;            // sched_trigger chamado desde o início da última execução
+    uint64_t release_us;       // Próxima liberação
+
+    // Estatísticas
+    uint32_t runs;
+    uint32_t misses;           // Execuções que terminaram após o prazo
+    uint32_t last_us;          // Duração da última execução
+    uint32_t max_us;           // Maior duração observada
+    uint64_t total_us;         // Tempo total de execução
+    uint32_t max_late_us;      // Maior atraso entre liberação e início
+} sched_task_t;
+
+typedef struct {
+    sched_task_t tasks[SCHED_MAX_TASKS];
+    uint8_t count;
+    uint64_t (*now_us)(void);  // Relógio (hardware ou simulado)
+    sched_start_hook_t on_start;
+    sched_end_hook_t on_end;
+    void *hook_ctx;
+} sched_t;
+
+void sched_init(sched_t *s, uint64_t (*now_us)(void));
+void sched_set_hooks(sched_t *s, sched_start_hook_t on_start, sched_end_hook_t on_end, void *ctx);
+uint8_t sched_add_periodic(sched_t *s, const char *name, sched_fn_t fn, void *arg,
+                           uint32_t period_us, uint32_t deadline_us, uint8_t priority);
+uint8_t sched_add_oneshot(sched_t *s, const char *name, sched_fn_t fn, void *arg,
+                          uint32_t deadline_us, uint8_t priority);
+void sched_trigger(sched_t *s, uint8_t id, uint32_t delay_us);
+void sched_cancel(sched_t *s, uint8_t id);
+void sched_set_period(sched_t *s, uint8_t id, uint32_t period_us);
+bool sched_run_once(sched_t *s);
+uint64_t sched_next_release(const sched_t *s);
+void sched_reset_stats(sched_t *s);
+
+#endif
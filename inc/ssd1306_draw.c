@@ -0,0 +1,102 @@
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "ssd1306_font.h"
+#include "ssd1306.h"
+
+// Limpa o quadro da instância (não envia ao display)
+void ssd1306_clear(ssd1306_t *ssd) {
+    memset(ssd->ram_buffer + 1, 0, ssd->bufsize - 1);
+}
+
+// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
+void ssd1306_set_pixel(ssd1306_t *ssd, int x, int y, bool set) {
+    assert(x >= 0 && x < ssd->width && y >= 0 && y < ssd->height);
+
+    const int bytes_per_row = ssd->width;
+
+    int byte_idx = (y / 8) * bytes_per_row + x + 1; // +1: byte de controle
+    uint8_t byte = ssd->ram_buffer[byte_idx];
+
+    if (set) {
+        byte |= 1 << (y % 8);
+    }
+    else {
+        byte &= ~(1 << (y % 8));
+    }
+
+    ssd->ram_buffer[byte_idx] = byte;
+}
+
+// Algoritmo de Bresenham básico
+void ssd1306_draw_line(ssd1306_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
+    int dx = abs(x_1 - x_0); // Deslocamentos
+    int dy = -abs(y_1 - y_0);
+    int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
+    int sy = y_0 < y_1 ? 1 : -1;
+    int error = dx + dy; // Erro acumulado
+    int error_2;
+
+    while (true) {
+        ssd1306_set_pixel(ssd, x_0, y_0, set); // Acende pixel no ponto atual
+        if (x_0 == x_1 && y_0 == y_1) {
+            break; // Verifica se o ponto final foi alcançado
+        }
+
+        error_2 = 2 * error; // Ajusta o erro acumulado
+
+        if (error_2 >= dy) {
+            error += dy;
+            x_0 += sx; // Avança na direção x
+        }
+        if (error_2 <= dx) {
+            error += dx;
+            y_0 += sy; // Avança na direção y
+        }
+    }
+}
+
+
+int ssd1306_get_font(uint8_t character) {
+    // Mapeamento personalizado (exemplo):
+    if (character >= 'A' && character <= 'Z') {
+        return (character - 'A') + 1; // A-Z nos índices 1-26
+    } 
+    else if (character >= '0' && character <= '9') {
+        return (character - '0') + 27; // 0-9 nos índices 27-36
+    } 
+    else if (character >= 'a' && character <= 'z') {
+        return (character - 'a') + 37; // a-z nos índices 37-62
+    } 
+    else {
+        return 0; // Índice 0 para caracteres inválidos
+    }
+}
+
+void ssd1306_draw_char(ssd1306_t *ssd, int16_t x, int16_t y, uint8_t character) {
+    if (x > ssd->width - 8 || y > ssd->height - 8) {
+        return;
+    }
+
+    y = y / 8; // Ajuste para modo de página (8 linhas por página)
+
+    // Remove toupper() para permitir minúsculas
+    int idx = ssd1306_get_font(character); // Função deve mapear 'a' para o índice correto
+    int fb_idx = y * ssd->width + x + 1; // Largura da instância; +1: byte de controle
+
+    for (int i = 0; i < 8; i++) {
+        ssd->ram_buffer[fb_idx++] = font[idx * 8 + i];
+    }
+}
+
+// Desenha uma string, chamando a função de desenhar caractere várias vezes
+void ssd1306_draw_string(ssd1306_t *ssd, int16_t x, int16_t y, const char *string) {
+    if (x > ssd->width - 8 || y > ssd->height - 8) {
+        return;
+    }
+
+    while (*string) {
+        ssd1306_draw_char(ssd, x, y, *string++);
+        x += 8;
+    }
+}
@@ -5,244 +5,222 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
-#include "ssd1306_font.h"
-#include "ssd1306_i2c.h"
+#include "ssd1306.h"
 
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area) {
     area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
 }
 
-// Processo de escrita do i2c espera um byte de controle, seguido por dados
-void ssd1306_send_command(uint8_t command) {
-    uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
-}
-
-// Envia uma lista de comandos ao hardware
-void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
+// Comando de configuração com base na estrutura ssd1306_t
+void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+    ssd->port_buffer[1] = command;
+    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false);
+}
+
+// Envia uma lista de comandos numa única transação (byte de controle 0x00 seguido dos comandos)
+void ssd1306_send_command_list(ssd1306_t *ssd, const uint8_t *commands, int number) {
+    uint8_t buffer[32];
+    while (number > 0) {
+        int n = number < (int)sizeof(buffer) - 1 ? number : (int)sizeof(buffer) - 1;
+        buffer[0] = 0x00;
+        memcpy(buffer + 1, commands, n);
+        i2c_write_blocking(ssd->i2c_port, ssd->address, buffer, n + 1, false);
+        commands += n;
+        number -= n;
     }
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
-void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
-
-    temp_buffer[0] = 0x40;
-    memcpy(temp_buffer + 1, ssd, buffer_length);
-
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
-
-    free(temp_buffer);
+// Inicializa a instância do display: barramento, endereço, geometria e buffer
+void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+    ssd->width = width;
+    ssd->height = height;
+    ssd->pages = height / 8U;
+    ssd->address = address;
+    ssd->i2c_port = i2c;
+    ssd->external_vcc = external_vcc;
+    ssd->bufsize = ssd->pages * ssd->width + 1;
+    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+    ssd->ram_buffer[0] = 0x40;
+    ssd->port_buffer[0] = 0x80;
 }
 
-// Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
-void ssd1306_init() {
-    uint8_t commands[] = {
+// Envia a sequência de inicialização de acordo com a geometria da instância
+void ssd1306_config(ssd1306_t *ssd) {
+    const uint8_t commands[] = {
         ssd1306_set_display, ssd1306_set_memory_mode, 0x00,
-        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01, 
-        ssd1306_set_mux_ratio, ssd1306_height - 1,
+        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, ssd->height - 1,
         ssd1306_set_common_output_direction | 0x08, ssd1306_set_display_offset,
         0x00, ssd1306_set_common_pin_configuration,
-    
-#if ((ssd1306_width == 128) && (ssd1306_height == 32))
-    0x02,
-#elif ((ssd1306_width == 128) && (ssd1306_height == 64))
-    0x12,
-#else
-    0x02,
-#endif
+        (ssd->height == 64) ? 0x12 : 0x02, // 128x64 usa COM alternado, 128x32 sequencial
         ssd1306_set_display_clock_divide_ratio, 0x80, ssd1306_set_precharge,
-        0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
+        ssd->external_vcc ? 0x22 : 0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
         0xFF, ssd1306_set_entire_on, ssd1306_set_normal_display,
-        ssd1306_set_charge_pump, 0x14, ssd1306_set_scroll | 0x00,
+        ssd1306_set_charge_pump, ssd->external_vcc ? 0x10 : 0x14, ssd1306_set_scroll | 0x00,
         ssd1306_set_display | 0x01,
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
 }
 
 // Cria a lista de comandos para configurar o scrolling
-void ssd1306_scroll(bool set) {
-    uint8_t commands[] = {
-        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, 0x03,
+void ssd1306_scroll(ssd1306_t *ssd, bool set) {
+    const uint8_t commands[] = {
+        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, ssd->pages - 1,
         0x00, 0xFF, ssd1306_set_scroll | (set ? 0x01 : 0)
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
 }
 
-// Atualiza uma parte do display com uma área de renderização
-void render_on_display(uint8_t *ssd, struct render_area *area) {
-    uint8_t commands[] = {
-        ssd1306_set_column_address, area->start_column, area->end_column,
-        ssd1306_set_page_address, area->start_page, area->end_page
+// Define a janela de colunas e páginas que receberá os próximos dados
+static void ssd1306_set_window(ssd1306_t *ssd, uint8_t start_column, uint8_t end_column, uint8_t start_page, uint8_t end_page) {
+    const uint8_t commands[] = {
+        ssd1306_set_column_address, start_column, end_column,
+        ssd1306_set_page_address, start_page, end_page
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
-    ssd1306_send_buffer(ssd, area->buffer_length);
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
 }
 
-// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
-void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
-    assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
-
-    const int bytes_per_row = ssd1306_width;
-
-    int byte_idx = (y / 8) * bytes_per_row + x;
-    uint8_t byte = ssd[byte_idx];
-
-    if (set) {
-        byte |= 1 << (y % 8);
-    }
-    else {
-        byte &= ~(1 << (y % 8));
-    }
-
-    ssd[byte_idx] = byte;
-}
-
-// Algoritmo de Bresenham básico
-void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
-    int dx = abs(x_1 - x_0); // Deslocamentos
-    int dy = -abs(y_1 - y_0);
-    int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
-    int sy = y_0 < y_1 ? 1 : -1;
-    int error = dx + dy; // Erro acumulado
-    int error_2;
-
-    while (true) {
-        ssd1306_set_pixel(ssd, x_0, y_0, set); // Acende pixel no ponto atual
-        if (x_0 == x_1 && y_0 == y_1) {
-            break; // Verifica se o ponto final foi alcançado
-        }
-
-        error_2 = 2 * error; // Ajusta o erro acumulado
-
-        if (error_2 >= dy) {
-            error += dy;
-            x_0 += sx; // Avança na direção x
+// Envia o quadro inteiro ao display
+void ssd1306_send_data(ssd1306_t *ssd) {
+    ssd1306_set_window(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false);
+}
+
+// Estado de uma transferência intercalada
+typedef struct {
+    ssd1306_t *ssd;
+    size_t pos;
+    bool started, done;
+} ssd1306_tx_t;
+
+// Aborta as transferências iniciadas e não concluídas: o controlador descarta o FIFO
+// de TX e gera STOP, deixando o barramento pronto para o próximo i2c_write_blocking
+static void ssd1306_abort_pending(ssd1306_tx_t tx[], int count) {
+    for (int d = 0; d < count; d++) {
+        if (!tx[d].started || tx[d].done) {
+            continue;
         }
-        if (error_2 <= dx) {
-            error += dx;
-            y_0 += sy; // Avança na direção y
+        i2c_hw_t *hw = i2c_get_hw(tx[d].ssd->i2c_port);
+        hw->enable |= I2C_IC_ENABLE_ABORT_BITS;
+        uint64_t limit = time_us_64() + ssd1306_abort_timeout_us;
+        while ((hw->enable & I2C_IC_ENABLE_ABORT_BITS) && time_us_64() < limit) {
+            tight_loop_contents();
         }
+        (void)hw->clr_tx_abrt;
+        tx[d].done = true;
     }
 }
 
-
-int ssd1306_get_font(uint8_t character) {
-    // Mapeamento personalizado (exemplo):
-    if (character >= 'A' && character <= 'Z') {
-        return (character - 'A') + 1; // A-Z nos índices 1-26
-    } 
-    else if (character >= '0' && character <= '9') {
-        return (character - '0') + 27; // 0-9 nos índices 27-36
-    } 
-    else if (character >= 'a' && character <= 'z') {
-        return (character - 'a') + 37; // a-z nos índices 37-62
-    } 
-    else {
-        return 0; // Índice 0 para caracteres inválidos
+// Envia o quadro de vários displays ao mesmo tempo. Cada barramento atende um display
+// por vez, mas os FIFOs de i2c0 e i2c1 são alimentados alternadamente, de modo que
+// dois displays em barramentos diferentes atualizam em aproximadamente o tempo de um.
+// Retorna o número de displays atualizados sem erro.
+int ssd1306_send_data_multi(ssd1306_t *displays[], int count) {
+    ssd1306_tx_t tx[ssd1306_max_displays];
+    if (count > ssd1306_max_displays) {
+        count = ssd1306_max_displays;
     }
-}
 
-void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
-        return;
+    // A janela de endereçamento é curta e vai de forma bloqueante
+    for (int d = 0; d < count; d++) {
+        ssd1306_set_window(displays[d], 0, displays[d]->width - 1, 0, displays[d]->pages - 1);
+        tx[d] = (ssd1306_tx_t){ .ssd = displays[d] };
     }
 
-    y = y / 8; // Ajuste para modo de página (8 linhas por página)
-
-    // Remove toupper() para permitir minúsculas
-    int idx = ssd1306_get_font(character); // Função deve mapear 'a' para o índice correto
-    int fb_idx = y * 128 + x; // Assume display 128x64
+    int ok = 0;
+    int pending = count;
+    uint64_t deadline = time_us_64() + (uint64_t)ssd1306_tx_timeout_us * count;
+
+    while (pending > 0) {
+        for (int d = 0; d < count; d++) {
+            if (tx[d].done) {
+                continue;
+            }
+            ssd1306_t *ssd = tx[d].ssd;
+            i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+
+            // Só um display por barramento: espera os anteriores do mesmo barramento
+            bool bus_busy = false;
+            for (int o = 0; o < d; o++) {
+                if (!tx[o].done && tx[o].ssd->i2c_port == ssd->i2c_port) {
+                    bus_busy = true;
+                    break;
+                }
+            }
+            if (bus_busy) {
+                continue;
+            }
+
+            if (!tx[d].started) {
+                hw->enable = 0;
+                hw->tar = ssd->address;
+                hw->enable = 1;
+                (void)hw->clr_stop_det; // Descarta o STOP da janela de endereçamento
+                tx[d].started = true;
+            }
+
+            // Preenche o FIFO de TX com o que couber, sem esperar
+            size_t room = i2c_get_write_available(ssd->i2c_port);
+            while (room-- > 0 && tx[d].pos < ssd->bufsize) {
+                bool last = tx[d].pos == ssd->bufsize - 1;
+                hw->data_cmd = ssd->ram_buffer[tx[d].pos++] | (last ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+            }
+
+            if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+                (void)hw->clr_tx_abrt; // Display ausente ou sem ACK
+                tx[d].done = true;
+                pending--;
+            } else if (tx[d].pos == ssd->bufsize && (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)) {
+                (void)hw->clr_stop_det;
+                tx[d].done = true;
+                pending--;
+                ok++;
+            }
+        }
 
-    for (int i = 0; i < 8; i++) {
-        ssd[fb_idx++] = font[idx * 8 + i];
+        if (time_us_64() > deadline) {
+            ssd1306_abort_pending(tx, count); // Barramento travado: desiste em vez de bloquear para sempre
+            break;
+        }
     }
+    return ok;
 }
 
-// Desenha uma string, chamando a função de desenhar caractere várias vezes
-void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
+// Atualiza uma parte do display com uma área de renderização do quadro da instância
+void render_on_display(ssd1306_t *ssd, struct render_area *area) {
+    calculate_render_area_buffer_length(area);
+    ssd1306_set_window(ssd, area->start_column, area->end_column, area->start_page, area->end_page);
+
+    uint8_t *frame = ssd->ram_buffer + 1;
+    int columns = area->end_column - area->start_column + 1;
+
+    if (columns == ssd->width) {
+        // Páginas inteiras são contíguas no quadro: envia direto, emprestando o byte
+        // anterior para o byte de controle
+        uint8_t *start = frame + area->start_page * ssd->width - 1;
+        uint8_t saved = *start;
+        *start = 0x40;
+        i2c_write_blocking(ssd->i2c_port, ssd->address, start, area->buffer_length + 1, false);
+        *start = saved;
         return;
     }
 
-    while (*string) {
-        ssd1306_draw_char(ssd, x, y, *string++);
-        x += 8;
+    // Área parcial: uma transação por página
+    for (int page = area->start_page; page <= area->end_page; page++) {
+        uint8_t *start = frame + page * ssd->width + area->start_column - 1;
+        uint8_t saved = *start;
+        *start = 0x40;
+        i2c_write_blocking(ssd->i2c_port, ssd->address, start, columns + 1, false);
+        *start = saved;
     }
 }
 
-// Comando de configuração com base na estrutura ssd1306_t
-void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-	ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false );
-}
-
-// Função de configuração do display para o caso do bitmap
-void ssd1306_config(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_display | 0x00);
-    ssd1306_command(ssd, ssd1306_set_memory_mode);
-    ssd1306_command(ssd, 0x01);
-    ssd1306_command(ssd, ssd1306_set_display_start_line | 0x00);
-    ssd1306_command(ssd, ssd1306_set_segment_remap | 0x01);
-    ssd1306_command(ssd, ssd1306_set_mux_ratio);
-    ssd1306_command(ssd, ssd1306_height - 1);
-    ssd1306_command(ssd, ssd1306_set_common_output_direction | 0x08);
-    ssd1306_command(ssd, ssd1306_set_display_offset);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd1306_set_common_pin_configuration);
-    ssd1306_command(ssd, 0x12);
-    ssd1306_command(ssd, ssd1306_set_display_clock_divide_ratio);
-    ssd1306_command(ssd, 0x80);
-    ssd1306_command(ssd, ssd1306_set_precharge);
-    ssd1306_command(ssd, 0xF1);
-    ssd1306_command(ssd, ssd1306_set_vcomh_deselect_level);
-    ssd1306_command(ssd, 0x30);
-    ssd1306_command(ssd, ssd1306_set_contrast);
-    ssd1306_command(ssd, 0xFF);
-    ssd1306_command(ssd, ssd1306_set_entire_on);
-    ssd1306_command(ssd, ssd1306_set_normal_display);
-    ssd1306_command(ssd, ssd1306_set_charge_pump);
-    ssd1306_command(ssd, 0x14);
-    ssd1306_command(ssd, ssd1306_set_display | 0x01);
-}
-
-// Inicializa o display para o caso de exibição de bitmap
-void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
-    ssd->width = width;
-    ssd->height = height;
-    ssd->pages = height / 8U;
-    ssd->address = address;
-    ssd->i2c_port = i2c;
-    ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    ssd->ram_buffer[0] = 0x40;
-    ssd->port_buffer[0] = 0x80;
-}
-
-// Envia os dados ao display
-void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_column_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, ssd1306_set_page_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(
-    ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false );
-}
-
-// Desenha o bitmap (a ser fornecido em display_oled.c) no display
+// Copia o bitmap (no formato de páginas do display) para o quadro e envia ao display
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
-        ssd->ram_buffer[i + 1] = bitmap[i];
-
-        ssd1306_send_data(ssd);
-    }
+    memcpy(ssd->ram_buffer + 1, bitmap, ssd->bufsize - 1);
+    ssd1306_send_data(ssd);
 }
@@ -5,8 +5,8 @@
 #ifndef ssd1306_inc_h
 #define ssd1306_inc_h
 
-#define ssd1306_height 64 // Define a altura do display (32 pixels)
-#define ssd1306_width 128 // Define a largura do display (128 pixels)
+#define ssd1306_height 64 // Altura padrão do display (32 ou 64 pixels)
+#define ssd1306_width 128 // Largura padrão do display (128 pixels)
 
 #define ssd1306_i2c_address _u(0x3C) // Define o endereço do i2c do display
 
@@ -44,6 +44,10 @@
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
 #define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
 
+#define ssd1306_max_displays 4 // Displays atualizados juntos por ssd1306_send_data_multi
+#define ssd1306_tx_timeout_us 50000 // Limite de uma transferência intercalada
+#define ssd1306_abort_timeout_us 1000 // Limite para o controlador concluir o abort após o timeout
+
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
@@ -56,6 +60,8 @@ struct render_area {
     int buffer_length;
 };
 
+// Instância de um display: barramento, endereço, geometria e quadro em RAM.
+// ram_buffer[0] guarda o byte de controle 0x40; o quadro começa em ram_buffer[1].
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t * i2c_port;
@@ -0,0 +1,144 @@
+#include <string.h>
+#include "telemetry.h"
+
+// CRC-8 com polinômio 0x07, valor inicial 0
+uint8_t telemetry_crc8(const uint8_t *p, size_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return get16(p) | (uint32_t)get16(p + 2) << 16;
+}
+
+// Serializa um registro no formato de TELEMETRY_RECORD_LEN bytes
+void telemetry_encode(const telemetry_record_t *rec, uint8_t out[TELEMETRY_RECORD_LEN]) {
+    out[0] = TELEMETRY_SYNC0;
+    out[1] = TELEMETRY_SYNC1;
+    put16(&out[2], rec->seq);
+    put32(&out[4], rec->time_ms);
+    put16(&out[8], rec->adc_raw);
+    put16(&out[10], rec->adc_filtered);
+    put32(&out[12], rec->distance_m);
+    put16(&out[16], rec->eta_s);
+    out[18] = rec->flags;
+    out[19] = telemetry_crc8(&out[2], TELEMETRY_RECORD_LEN - 3);
+}
+
+// Valida sync e CRC e desserializa; retorna false se o registro estiver corrompido
+bool telemetry_decode(const uint8_t in[TELEMETRY_RECORD_LEN], telemetry_record_t *rec) {
+    if (in[0] != TELEMETRY_SYNC0 || in[1] != TELEMETRY_SYNC1 ||
+        telemetry_crc8(&in[2], TELEMETRY_RECORD_LEN - 3) != in[19]) {
+        return false;
+    }
+    rec->seq = get16(&in[2]);
+    rec->time_ms = get32(&in[4]);
+    rec->adc_raw = get16(&in[8]);
+    rec->adc_filtered = get16(&in[10]);
+    rec->distance_m = get32(&in[12]);
+    rec->eta_s = get16(&in[16]);
+    rec->flags = in[18];
+    return true;
+}
+
+// Associa a fila a um buffer de tamanho potência de 2
+void telemetry_init(telemetry_t *t, uint8_t *buf, size_t cap, uint16_t decimation, uint8_t ema_shift) {
+    memset(t, 0, sizeof(*t));
+    t->buf = buf;
+    t->cap = cap;
+    t->ema_shift = ema_shift;
+    telemetry_set_decimation(t, decimation);
+}
+
+void telemetry_set_decimation(telemetry_t *t, uint16_t decimation) {
+    t->decimation = decimation ? decimation : 1;
+    t->phase = 0;
+}
+
+// Atualiza a média móvel exponencial com uma amostra e retorna o valor filtrado
+uint16_t telemetry_filter(telemetry_t *t, uint16_t raw) {
+    int32_t x = (int32_t)raw << 8;
+    if (!t->ema_valid) {
+        t->ema_q8 = x;
+        t->ema_valid = true;
+    } else {
+        t->ema_q8 += (x - t->ema_q8) >> t->ema_shift;
+    }
+    return (uint16_t)((t->ema_q8 + 128) >> 8);
+}
+
+// Conta uma amostra; retorna true quando ela deve gerar um registro (decimação)
+bool telemetry_due(telemetry_t *t) {
+    if (++t->phase < t->decimation) {
+        return false;
+    }
+    t->phase = 0;
+    return true;
+}
+
+// Enfileira um registro, preenchendo seq e a marca de perda. Com a fila cheia o
+// registro é descartado e o próximo enfileirado leva TELEMETRY_FLAG_LOSS.
+bool telemetry_push(telemetry_t *t, telemetry_record_t *rec) {
+    size_t head = t->head;
+    if (t->cap - (head - t->tail) < TELEMETRY_RECORD_LEN) {
+        t->loss = true;
+        t->dropped++;
+        t->seq++; // A lacuna em seq indica ao receptor quantos registros faltam
+        return false;
+    }
+    rec->seq = t->seq++;
+    if (t->loss) {
+        rec->flags |= TELEMETRY_FLAG_LOSS;
+        t->loss = false;
+    }
+
+    uint8_t bytes[TELEMETRY_RECORD_LEN];
+    telemetry_encode(rec, bytes);
+    for (size_t i = 0; i < TELEMETRY_RECORD_LEN; i++) {
+        t->buf[(head + i) & (t->cap - 1)] = bytes[i];
+    }
+    t->head = head + TELEMETRY_RECORD_LEN;
+    t->queued++;
+    return true;
+}
+
+size_t telemetry_pending(const telemetry_t *t) {
+    return t->head - t->tail;
+}
+
+// Bytes contíguos prontos para envio a partir de *p (até o fim do buffer circular)
+size_t telemetry_peek(const telemetry_t *t, const uint8_t **p) {
+    size_t tail = t->tail;
+    size_t offset = tail & (t->cap - 1);
+    size_t n = t->head - tail;
+    if (n > t->cap - offset) {
+        n = t->cap - offset;
+    }
+    *p = &t->buf[offset];
+    return n;
+}
+
+// Libera n bytes já enviados
+void telemetry_consume(telemetry_t *t, size_t n) {
+    t->tail += n;
+}
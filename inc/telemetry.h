@@ -0,0 +1,70 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef telemetry_inc_h
+#define telemetry_inc_h
+
+// Registro binário de tamanho fixo (little-endian):
+//   0  sync 0xA5 0x5A
+//   2  seq          u16   contador de registros (lacunas = registros perdidos)
+//   4  time_ms      u32   instante da amostra
+//   8  adc_raw      u16   leitura de 12 bits do ADC
+//   10 adc_filtered u16   leitura filtrada (média móvel exponencial)
+//   12 distance_m   u32   distância percorrida
+//   16 eta_s        u16   tempo estimado de chegada
+//   18 flags        u8    TELEMETRY_FLAG_*
+//   19 crc8         u8    CRC-8 (polinômio 0x07) dos bytes 2 a 18
+#define TELEMETRY_RECORD_LEN 20
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+
+enum {
+    TELEMETRY_FLAG_ALARM = 1 << 0,     // Alarme acionado pelo botão C
+    TELEMETRY_FLAG_ANIM = 1 << 1,      // Animação da matriz em andamento
+    TELEMETRY_FLAG_TRACE = 1 << 2,     // Gravação de trace ativa
+    TELEMETRY_FLAG_LOSS = 1 << 3       // Registros descartados antes deste (fila cheia)
+};
+
+typedef struct {
+    uint16_t seq;
+    uint32_t time_ms;
+    uint16_t adc_raw;
+    uint16_t adc_filtered;
+    uint32_t distance_m;
+    uint16_t eta_s;
+    uint8_t flags;
+} telemetry_record_t;
+
+// Fila de transmissão e controle de taxa. O buffer tem tamanho potência de 2;
+// a fila só recebe registros inteiros, então o leitor nunca vê um registro cortado.
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    volatile size_t head;              // Próxima escrita (produtor)
+    volatile size_t tail;              // Próxima leitura (consumidor)
+    uint16_t seq;
+    uint16_t decimation;               // Um registro a cada N amostras
+    uint16_t phase;
+    uint8_t ema_shift;                 // Filtro: alfa = 1 / 2^ema_shift
+    int32_t ema_q8;                    // Estado do filtro em ponto fixo 8.8
+    bool ema_valid;
+    bool loss;                         // Houve descarte desde o último registro enfileirado
+    uint32_t queued;
+    uint32_t dropped;
+} telemetry_t;
+
+uint8_t telemetry_crc8(const uint8_t *p, size_t len);
+void telemetry_encode(const telemetry_record_t *rec, uint8_t out[TELEMETRY_RECORD_LEN]);
+bool telemetry_decode(const uint8_t in[TELEMETRY_RECORD_LEN], telemetry_record_t *rec);
+
+void telemetry_init(telemetry_t *t, uint8_t *buf, size_t cap, uint16_t decimation, uint8_t ema_shift);
+void telemetry_set_decimation(telemetry_t *t, uint16_t decimation);
+uint16_t telemetry_filter(telemetry_t *t, uint16_t raw);
+bool telemetry_due(telemetry_t *t);
+bool telemetry_push(telemetry_t *t, telemetry_record_t *rec);
+size_t telemetry_pending(const telemetry_t *t);
+size_t telemetry_peek(const telemetry_t *t, const uint8_t **p);
+void telemetry_consume(telemetry_t *t, size_t n);
+
+#endif
@@ -0,0 +1,104 @@
+#include <string.h>
+#include "trace.h"
+
+// Escreve um inteiro em LEB128 (7 bits por byte, bit 7 indica continuação)
+static size_t trace_put_varint(uint8_t *p, uint32_t v) {
+    size_t n = 0;
+    do {
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        p[n++] = b | (v ? 0x80 : 0);
+    } while (v);
+    return n;
+}
+
+// Lê um inteiro em LEB128; retorna false se os dados acabarem no meio
+static bool trace_get_varint(const uint8_t **p, const uint8_t *end, uint32_t *v) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*p >= end) {
+            return false;
+        }
+        uint8_t b = *(*p)++;
+        out |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = out;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Associa o gravador a um buffer (inativo até trace_start)
+void trace_init(trace_t *t, uint8_t *buf, size_t cap) {
+    memset(t, 0, sizeof(*t));
+    t->buf = buf;
+    t->cap = cap;
+}
+
+// Descarta a gravação anterior e começa uma nova a partir de now_us
+void trace_start(trace_t *t, uint64_t now_us) {
+    memcpy(t->buf, TRACE_MAGIC, 4);
+    t->buf[4] = TRACE_VERSION;
+    t->buf[5] = t->buf[6] = t->buf[7] = 0;
+    t->len = TRACE_HEADER_LEN;
+    t->start_us = now_us;
+    t->last_us = now_us;
+    t->count = 0;
+    t->overflow = false;
+    t->active = true;
+}
+
+void trace_stop(trace_t *t) {
+    t->active = false;
+}
+
+// Acrescenta um evento; retorna false se inativo ou sem espaço
+bool trace_record(trace_t *t, uint64_t now_us, uint8_t type, uint32_t value) {
+    if (!t->active) {
+        return false;
+    }
+    if (t->len + TRACE_EVENT_MAX_LEN > t->cap) {
+        t->overflow = true;
+        t->active = false;
+        return false;
+    }
+    uint64_t delta = now_us > t->last_us ? now_us - t->last_us : 0;
+    if (delta > UINT32_MAX) {
+        delta = UINT32_MAX;
+    }
+    t->len += trace_put_varint(&t->buf[t->len], (uint32_t)delta);
+    t->buf[t->len++] = type;
+    t->len += trace_put_varint(&t->buf[t->len], value);
+    t->last_us += delta;
+    t->count++;
+    return true;
+}
+
+// Valida o cabeçalho e posiciona o leitor no primeiro evento
+bool trace_reader_init(trace_reader_t *r, const uint8_t *buf, size_t len) {
+    if (len < TRACE_HEADER_LEN || memcmp(buf, TRACE_MAGIC, 4) != 0 || buf[4] != TRACE_VERSION) {
+        return false;
+    }
+    r->p = buf + TRACE_HEADER_LEN;
+    r->end = buf + len;
+    r->time_us = 0;
+    return true;
+}
+
+// Lê o próximo evento; retorna false no fim do trace
+bool trace_next(trace_reader_t *r, trace_event_t *ev) {
+    uint32_t delta, value;
+    if (!trace_get_varint(&r->p, r->end, &delta) || r->p >= r->end) {
+        return false;
+    }
+    uint8_t type = *r->p++;
+    if (!trace_get_varint(&r->p, r->end, &value)) {
+        return false;
+    }
+    r->time_us += delta;
+    ev->time_us = r->time_us;
+    ev->type = type;
+    ev->value = value;
+    return true;
+}
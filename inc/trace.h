@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef trace_inc_h
+#define trace_inc_h
+
+// Formato: cabeçalho de 8 bytes seguido de eventos
+//   cabeçalho: 'B' 'T' 'R' 'C', versão, 3 bytes reservados
+//   evento:    delta_us (varint LEB128), tipo (1 byte), valor (varint LEB128)
+#define TRACE_MAGIC "BTRC"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_LEN 8
+#define TRACE_EVENT_MAX_LEN 11     // 5 bytes de delta + tipo + 5 bytes de valor
+
+// Tipos de evento de entrada
+enum {
+    TRACE_EV_ADC = 1,              // Leitura de 12 bits do ADC do joystick
+    TRACE_EV_BUTTON = 2,           // Borda de descida em um botão (valor = GPIO)
+    TRACE_EV_SERIAL = 3            // Byte recebido pela serial
+};
+
+typedef struct {
+    uint64_t time_us;              // Instante absoluto desde o início da gravação
+    uint8_t type;
+    uint32_t value;
+} trace_event_t;
+
+// Gravador em buffer fornecido pelo chamador
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    uint64_t start_us;
+    uint64_t last_us;
+    uint32_t count;
+    bool active;
+    bool overflow;                 // Buffer cheio: eventos posteriores descartados
+} trace_t;
+
+// Leitor sequencial de um trace gravado
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    uint64_t time_us;
+} trace_reader_t;
+
+void trace_init(trace_t *t, uint8_t *buf, size_t cap);
+void trace_start(trace_t *t, uint64_t now_us);
+void trace_stop(trace_t *t);
+bool trace_record(trace_t *t, uint64_t now_us, uint8_t type, uint32_t value);
+bool trace_reader_init(trace_reader_t *r, const uint8_t *buf, size_t len);
+bool trace_next(trace_reader_t *r, trace_event_t *ev);
+
+#endif
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <ctype.h>
 #include "pico/stdlib.h"       // Funções padrão do Pico
 #include "hardware/pio.h"      // Interface para Programmed I/O
@@ -17,15 +18,29 @@
 #include "hardware/i2c.h"      // Comunicação I2C
 #include "hardware/adc.h"      // Conversor Analógico-Digital
 #include "hardware/pwm.h"      // Modulação por largura de pulso
-#include "ws2818b.pio.h"       // Programa PIO para LEDs WS2812B
+#include "hardware/sync.h"     // Seções críticas (gravação de eventos)
+#include "hardware/flash.h"    // Setor reservado à tabela de paradas
+#include "tusb.h"               // Escrita direta na USB CDC (telemetria binária)
 #include "inc/ssd1306.h"       // Biblioteca para display OLED SSD1306
+#include "inc/np_color.h"      // Gamma, brilho e dithering da matriz de LEDs
+#include "inc/np_anim.h"       // Animação por quadros-chave da matriz de LEDs
+#include "inc/np_geometry.h"   // Mapeamento de coordenadas para a cadeia de LEDs
+#include "inc/np_driver.h"     // Envio paralelo das fitas WS2812B via PIO + DMA
+#include "inc/scheduler.h"     // Escalonador cooperativo com prazos
+#include "inc/trace.h"         // Gravação de eventos de entrada para replay
+#include "inc/telemetry.h"     // Registros binários de telemetria
+#include "inc/loop_monitor.h"  // Histogramas do loop, orçamento e watchdog
+#include "inc/route_table.h"   // Tabela de paradas da linha
 
 // Definições de pinos usados no hardware
-#define LED_COUNT 25           // Número de LEDs na matriz
 #define LED_PIN 7              // Pino para a matriz de LEDs WS2812B
 #define WS2812_PIN 7           // Mesmo pino que LED_PIN (mantido para compatibilidade)
 #define EIXO_Y 26              // Pino ADC0 para eixo Y do joystick
 #define EIXO_X 27              // Pino ADC1 para eixo X do joystick
+#define LUZ_AMBIENTE_PIN 28    // Pino ADC2 para sensor de luz ambiente (LDR)
+#define LUZ_AMBIENTE_ADC 2     // Canal ADC do sensor de luz ambiente
+#define LUZ_AMBIENTE_ATIVA 0   // 1 para ajustar o brilho da matriz pelo sensor de luz
+#define BRILHO_PASSO 16        // Passo de ajuste do brilho pelos comandos '+' e '-'
 #define BLUE_LED_PIN 12        // Pino do LED azul
 #define RED_LED_PIN 13         // Pino do LED vermelho
 #define GREEN_LED_PIN 11       // Pino do LED verde
@@ -36,32 +51,164 @@
 #define I2C_SDA 14             // Pino SDA para comunicação I2C
 #define I2C_SCL 15             // Pino SCL para comunicação I2C
 
+// Geometria da matriz de LEDs (padrão: um painel 5x5 em serpentina, montado a 180°)
+#define NP_PANEL_WIDTH 5       // Colunas de cada painel
+#define NP_PANEL_HEIGHT 5      // Linhas de cada painel
+#define NP_TILES_X 1           // Painéis encadeados na horizontal
+#define NP_TILES_Y 1           // Painéis encadeados na vertical
+#define NP_WIDTH (NP_PANEL_WIDTH * NP_TILES_X)   // Largura total em LEDs
+#define NP_HEIGHT (NP_PANEL_HEIGHT * NP_TILES_Y) // Altura total em LEDs
+#define LED_COUNT (NP_WIDTH * NP_HEIGHT)         // Número de LEDs na matriz
+#define NP_STRIP_COUNT 1       // Fitas em paralelo (até 4, cada uma em sua máquina de estado)
+#define NP_STRIP_PINS {LED_PIN} // Pinos das fitas, ex.: {7, 8, 9, 10}
+#define PADRAO_LADO 5          // Lado dos padrões em digits[]
+#define PADRAO_X ((NP_WIDTH - PADRAO_LADO) / 2)  // Padrões centralizados na matriz
+#define PADRAO_Y ((NP_HEIGHT - PADRAO_LADO) / 2)
+
 // Definição do porto I2C usado
 #define I2C_PORT i2c1          // Porta I2C1 para comunicação com o display OLED
+#define OLED_ALTURA 64         // Altura do display principal (32 ou 64)
 
-// Estrutura para representar um pixel RGB na matriz de LEDs
-struct pixel_t {
-    uint8_t G, R, B;           // Componentes verde, vermelho e azul
-};
-typedef struct pixel_t pixel_t;
-typedef pixel_t npLED_t;       // Tipo para LEDs NeoPixel
+// Segundo display opcional no outro barramento, atualizado em paralelo com o principal
+#define OLED2_ATIVO 0          // 1 para habilitar o segundo display
+#define OLED2_I2C_PORT i2c0    // Porta I2C0 para o segundo display
+#define OLED2_SDA 0            // Pino SDA do segundo display
+#define OLED2_SCL 1            // Pino SCL do segundo display
+#define OLED2_ALTURA 32        // Altura do segundo display (32 ou 64)
+#define OLED_COUNT (1 + OLED2_ATIVO) // Número de displays
+
+// Períodos, prazos e prioridades das tarefas (maior prioridade = mais urgente)
+#define BOTOES_PERIODO_US 100000   // Verificação de segurança; a interrupção do botão dispara a tarefa na hora
+#define SERIAL_PERIODO_US 100000   // Idem para a chegada de caracteres (USB/UART)
+#define SERIAL_FILA_BYTES 256      // Caracteres recebidos à espera da tarefa serial (potência de 2)
+#define SENSORES_PERIODO_US 50000  // Amostragem do ADC a cada 50 ms
+#define SENSORES_OCIOSO_US 500000  // Amostragem com leituras estáveis
+#define SENSORES_ESTAVEL 20        // Amostras sem mudança (1 s) antes de espaçar a amostragem
+#define DISPLAY_PRAZO_US 40000     // Quadro do OLED deve sair em até 40 ms
+#define DITHER_PERIODO_US 10000    // Reenvio do quadro parado até fechar o ciclo do dithering (100 Hz)
+#define ANIM_PRAZO_US 10000        // Quadro da animação deve sair em até 10 ms do tique do temporizador
+#define BUZZER_PRAZO_US 2000       // Desligamento do buzzer com até 2 ms de atraso
+#define PRIORIDADE_ALARME 4
+#define PRIORIDADE_ENTRADA 3
+#define PRIORIDADE_DISPLAY 2
+#define PRIORIDADE_SENSORES 1
+
+// Gravação de eventos de entrada (comandos 'r', 'R' e 'd')
+#define TRACE_BUF_BYTES 4096       // Capacidade do trace em RAM
+#define TRACE_ADC_ZONA_MORTA 16    // Variação mínima do ADC para gerar evento
+#define TRACE_DUMP_LINHA 32        // Bytes por linha no dump hexadecimal
+
+// Telemetria binária pela USB CDC
+#define TELEMETRIA_PERIODO_US 10000 // Amostragem do ADC a 100 Hz
+#define TELEMETRIA_DECIMACAO 10    // Um registro a cada 10 amostras (10 registros/s)
+#define TELEMETRIA_DECIMACAO_MAX 100 // Menor taxa ajustável por '<' (1 registro/s)
+#define TELEMETRIA_FILTRO 3        // Média móvel exponencial com alfa = 1/8
+#define TELEMETRIA_FILA_BYTES 1024 // Fila de transmissão (potência de 2)
+#define TELEMETRIA_ENVIO_US 5000   // Drenagem da fila a cada 5 ms
+
+// Monitor do loop principal
+#define LOOP_ORCAMENTO_US 30000    // Tarefa acima de 30 ms é registrada como estouro
+#define WATCHDOG_TIMEOUT_MS 2000   // Reset se o loop ficar 2 s sem voltar ao topo
+
+// Ociosidade: o núcleo dorme (WFE) até a próxima tarefa ou interrupção
+#define OCIOSO_MAX_US 1000000      // Maior sono contínuo (abaixo do timeout do watchdog)
+#define IDLE_LOW_CLOCK 0           // 1 para reduzir o clk_sys durante sonos longos
+#define OCIOSO_CLOCK_BAIXO_US 20000 // Sono mínimo previsto para reduzir o clock
+#define OCIOSO_DIVISOR 10          // clk_sys dividido por 10 durante o sono
+
+// Tabela de paradas da linha
+#define ROTA_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE) // Último setor da flash
+#define ROTA_FLASH ((const uint8_t *)(XIP_BASE + ROTA_FLASH_OFFSET))  // Tabela carregada, lida via XIP
+#define ROTA_CARGA_POR_TAREFA 256  // Caracteres consumidos por execução durante a carga
+#define ROTA_CARGA_TIMEOUT_US 10000000 // Carga abandonada após 10 s sem caracteres
+#define ADC_FAIXAS 5               // Faixas do joystick: origem, 3 intermediárias e terminal
+#define PADROES 5                  // Padrões definidos em digits[]
+
+// Tipo para LEDs NeoPixel (pixel_t definido em inc/np_color.h)
+typedef pixel_t npLED_t;
 
 // Variáveis globais
 npLED_t leds[LED_COUNT];       // Array para armazenar estado dos LEDs
-PIO np_pio;                    // Instância do PIO para controle da matriz de LEDs
-uint sm;                       // Máquina de estado do PIO
+uint32_t np_words[LED_COUNT];  // Quadro já codificado em palavras do PIO
+uint8_t np_dither[LED_COUNT * 3]; // Resto do dithering temporal por canal
+unsigned np_dither_ciclo = 0;   // Quadros de um ciclo do dithering do último quadro (0 = sem fração)
+unsigned np_dither_restantes = 0; // Reenvios que faltam do quadro parado
+uint8_t tarefa_dither = SCHED_NO_TASK; // Reenvio periódico de quadros parados
+np_driver_t np_drv;            // Fitas WS2812B (PIO + DMA)
+const np_geometry_t np_geo = { // Geometria física da matriz
+    .panel_width = NP_PANEL_WIDTH,
+    .panel_height = NP_PANEL_HEIGHT,
+    .tiles_x = NP_TILES_X,
+    .tiles_y = NP_TILES_Y,
+    .serpentine = true,
+    .tile_serpentine = true,
+    .rotation = NP_ROT_180
+};
+np_anim_t np_anim;             // Linha do tempo da animação da matriz
+ssd1306_t oled;                // Display OLED principal
+#if OLED2_ATIVO
+ssd1306_t oled2;               // Segundo display OLED
+#endif
+ssd1306_t *oleds[OLED_COUNT];  // Displays atualizados juntos
+sched_t sched;                 // Escalonador das tarefas do firmware
+uint8_t tarefa_display;        // Tarefa de disparo único que envia o quadro do OLED
+uint8_t tarefa_buzzer;         // Tarefa de disparo único que desliga o buzzer
+uint8_t tarefa_animacao;       // Tarefa de disparo único que gera os quadros da animação
+trace_t trace;                 // Gravador de eventos de entrada
+uint8_t trace_buf[TRACE_BUF_BYTES]; // Trace binário gravado
+uint16_t trace_ultimo_adc;     // Última leitura do ADC gravada
+telemetry_t telem;             // Fila e controle de taxa da telemetria
+uint8_t telem_fila[TELEMETRIA_FILA_BYTES]; // Registros aguardando envio pela USB
+uint16_t telem_decimacao = TELEMETRIA_DECIMACAO; // Amostras por registro
+bool telemetria_ativa = false; // Modo binário: mensagens de texto suprimidas
+uint8_t tarefa_telem;          // Tarefa que amostra e enfileira registros
+uint8_t tarefa_telem_envio;    // Tarefa que drena a fila para a USB
+loop_monitor_t loop_mon;       // Período, atraso e estouros do loop principal
+uint8_t tarefa_entrada_botoes; // Tarefas de entrada, disparadas pelas interrupções
+uint8_t tarefa_entrada_serial;
+uint8_t tarefa_amostragem;     // Tarefa dos sensores (período adaptativo)
+volatile bool serial_pendente = false; // Caracteres chegaram pela USB/UART
+uint8_t serial_fila[SERIAL_FILA_BYTES]; // Caracteres recebidos pela interrupção
+volatile uint32_t serial_recebidos = 0; // Total escrito na fila
+volatile uint32_t serial_lidos = 0; // Total consumido pela tarefa serial
+uint8_t sensores_estaveis = 0; // Amostras seguidas sem mudança no tempo de chegada
+uint sensores_ultimo_tempo = 0; // Tempo de chegada da amostra anterior
+volatile bool np_anim_timer_ativo = false; // Temporizador de quadros armado
+volatile uint32_t np_anim_tiques = 0; // Períodos de quadro contados pela interrupção
+uint32_t np_anim_tiques_lidos = 0; // Períodos já avançados pela tarefa da animação
+#if IDLE_LOW_CLOCK
+uint32_t clock_sys_hz;         // clk_sys nominal, restaurado ao acordar
+#endif
+uint8_t np_anim_rgb[PADRAO_LADO * PADRAO_LADO * 3]; // Quadro gerado pela animação
+repeating_timer_t np_anim_timer; // Temporizador de quadros da animação
+uint np_anim_tempo = 0;        // Tempo de chegada usado para montar a animação
 volatile int current_digit = 0; // Dígito atual exibido na matriz de LEDs
 volatile char c = '~';         // Último comando recebido (inicializado como '~')
 volatile bool new_data = false;// Flag para indicar novo comando recebido
 bool controle1 = false;        // Estado do botão A
 bool controle2 = false;        // Estado do botão B
 bool controle3 = false;        // Estado do botão C
-uint distancia_global = 0;     // Distância calculada globalmente
-uint tempo_global = 0;         // Tempo calculado globalmente
+uint distancia_global = 0;     // Distância percorrida na linha (m)
+uint tempo_global = 0;         // Tempo programado até o terminal (s)
 volatile bool botao_pressionado = false; // Flag para indicar botão pressionado
 volatile uint8_t botao_gpio = 0;        // Pino do botão que gerou interrupção
 absolute_time_t last_interrupt_time = 0;// Timestamp da última interrupção
 
+route_t rota;                  // Tabela de paradas ativa (aponta para a flash)
+route_loader_t rota_carga;     // Página em montagem durante a carga pela serial
+bool rota_carregando = false;  // Entrada serial é a imagem da tabela, não comandos
+uint64_t rota_carga_us = 0;    // Último caractere recebido durante a carga
+int rota_nibble = -1;          // Primeiro dígito hexadecimal de um byte da imagem
+
+// Linha padrão: uma parada para cada padrão de digits[], a 20 min uma da outra
+const route_stop_t rota_padrao[] = {
+    {"Rodoviaria", 0, 0, 0, 0},
+    {"Parada 1", 25000, 1200, 1, 0},
+    {"Parada 2", 50000, 2400, 2, 0},
+    {"Parada 3", 75000, 3600, 3, 0},
+    {"Parada 4", 100000, 4800, 4, 0}
+};
+
 // Matrizes para exibição de dígitos na matriz de LEDs (5x5 pixels, RGB)
 // Cada dígito/situação é representado por uma matriz de cores
 const uint8_t digits[11][5][5][3] = {
@@ -111,19 +258,70 @@ const uint8_t digits[11][5][5][3] = {
 void init_leds_and_buzzer();
 void pwm_init_buzzer(uint pin);
 void play_buzzer(uint pin, uint frequency, uint duration_ms);
+void stop_buzzer(uint pin);
 void npSetLED(uint index, uint8_t r, uint8_t g, uint8_t b);
 void npClear();
-void npInit(uint pin);
+void npInit();
 void npWrite();
+bool npShow(bool bloquear);
+bool npAnimTimerCallback(repeating_timer_t *t);
+void npAnimOnibusChegando(uint tempo);
+void npAnimParar();
 void npDisplayDigit(int digit);
+void npAjustarBrilho(int delta);
+void npLerLuzAmbiente();
 int getIndex(int x, int y);
+uint16_t ler_adc();
+int faixa_adc(uint16_t adc);
+uint32_t distancia_por_faixa(int faixa);
+void nome_parada(char *destino, uint16_t indice);
+void rota_ativar();
+void rota_apagar();
+void rota_gravar_pagina(uint32_t offset, const uint8_t *pagina);
+void rota_iniciar_carga();
+void rota_receber(char ch);
+void rota_cancelar_carga(const char *motivo);
+void imprimir_rota();
 float CalcularDistancia();
 float CalcularTempo();
-void process_command(int digit, char *line1, uint8_t *ssd, struct render_area *frame_area);
-void process_command_distancia(char c, char *line1, uint8_t *ssd, struct render_area *frame_area, float distancia);
-void process_command_tempo(char c, char *line1, uint8_t *ssd, struct render_area *frame_area, float tempo);
+void process_command(int digit, char *line1, ssd1306_t *ssd);
+void process_command_distancia(char c, char *line1, ssd1306_t *ssd, float distancia);
+void process_command_tempo(char c, char *line1, ssd1306_t *ssd, float tempo);
+void atualizar_displays();
+void agendar_display();
 void gpio_callback(uint gpio, uint32_t events);
 void tratar_botoes_e_display();
+void executar_comando(char c, ssd1306_t *ssd);
+void imprimir_estatisticas();
+void registrar_evento(uint8_t tipo, uint32_t valor);
+void trace_iniciar();
+void trace_parar();
+void trace_despejar();
+int mensagem(const char *fmt, ...);
+void telemetria_alternar();
+void telemetria_taxa(int fator);
+void monitor_inicio_tarefa(void *ctx, uint8_t id);
+void monitor_fim_tarefa(void *ctx, uint8_t id, uint32_t atraso_us, uint32_t execucao_us);
+const char *nome_estagio(uint8_t estagio);
+void imprimir_histograma();
+void serial_disponivel(void *param);
+void serial_receber();
+int ler_serial();
+void despachar_eventos();
+void ocioso_aguardar();
+bool clock_baixo_permitido();
+void clock_reduzir();
+void clock_restaurar();
+void imprimir_utilizacao();
+void tarefa_telemetria(void *arg);
+void tarefa_enviar_telemetria(void *arg);
+void tarefa_botoes(void *arg);
+void tarefa_serial(void *arg);
+void tarefa_sensores(void *arg);
+void tarefa_enviar_display(void *arg);
+void tarefa_desligar_buzzer(void *arg);
+void tarefa_reenviar_matriz(void *arg);
+void tarefa_animar_matriz(void *arg);
 
 // Inicializa os LEDs RGB e o buzzer como saídas
 void init_leds_and_buzzer() {
@@ -153,7 +351,8 @@ void pwm_init_buzzer(uint pin) {
     pwm_set_gpio_level(pin, 0); // Define nível inicial como 0
 }
 
-// Toca um som no buzzer com frequência e duração especificadas
+// Toca um som no buzzer com frequência e duração especificadas.
+// Não bloqueia: o desligamento é agendado no escalonador.
 void play_buzzer(uint pin, uint frequency, uint duration_ms) {
     gpio_set_function(pin, GPIO_FUNC_PWM); // Configura pino como PWM
     uint slice_num = pwm_gpio_to_slice_num(pin); // Obtém slice PWM
@@ -162,9 +361,13 @@ void play_buzzer(uint pin, uint frequency, uint duration_ms) {
     pwm_config_set_clkdiv(&config, clock_get_hz(clk_sys) / (frequency * 4096));
     pwm_init(slice_num, &config, true); // Inicializa PWM
     pwm_set_gpio_level(pin, 2048); // Define duty cycle de ~50%
-    sleep_ms(duration_ms); // Aguarda a duração especificada
+    sched_trigger(&sched, tarefa_buzzer, duration_ms * 1000); // Agenda o desligamento
+}
+
+// Desliga o buzzer
+void stop_buzzer(uint pin) {
     pwm_set_gpio_level(pin, 0); // Desliga o som
-    pwm_set_enabled(slice_num, false); // Desativa PWM
+    pwm_set_enabled(pwm_gpio_to_slice_num(pin), false); // Desativa PWM
 }
 
 // Define as cores de um LED na matriz
@@ -181,133 +384,251 @@ void npClear() {
 }
 
 // Inicializa a matriz de LEDs WS2812B usando PIO
-void npInit(uint pin) {
-    uint offset = pio_add_program(pio0, &ws2818b_program); // Carrega programa PIO
-    np_pio = pio0; // Usa PIO0
-    sm = pio_claim_unused_sm(np_pio, true); // Reserva máquina de estado
-    // Inicializa programa PIO com pino e frequência
-    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+void npInit() {
+    const uint pins[] = NP_STRIP_PINS;
+    // Uma máquina de estado e um canal DMA por fita
+    if (!npDriverInit(&np_drv, pins, NP_STRIP_COUNT, np_words, LED_COUNT)) {
+        printf("Matriz: sem maquina de estado ou canal DMA livre para todas as fitas\n");
+    }
+    npColorInit(); // Monta a tabela de gamma e brilho
     npClear(); // Limpa a matriz
 }
 
-// Escreve os dados dos LEDs na matriz
+// Escreve os dados dos LEDs na matriz. Um quadro com fração de dithering é reenviado
+// por uma tarefa periódica até fechar um ciclo, para a média chegar à cor pedida.
 void npWrite() {
-    for (uint i = 0; i < LED_COUNT; i++) {
-        // Envia componentes G, R, B para o PIO em sequência
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
+    npShow(true);
+    np_dither_restantes = np_dither_ciclo > 0 ? np_dither_ciclo - 1 : 0;
+    if (np_dither_restantes > 0 && !np_anim.running) {
+        sched_trigger(&sched, tarefa_dither, DITHER_PERIODO_US);
+    }
+}
+
+// Codifica o quadro atual e entrega ao PIO via DMA, sem esperar a transmissão.
+// Se o quadro anterior ainda não travou, espera (bloquear) ou descarta o novo quadro.
+bool npShow(bool bloquear) {
+    if (npDriverBusy(&np_drv)) {
+        if (!bloquear) {
+            return false;
+        }
+        npDriverWait(&np_drv);
+    }
+    // Gamma, brilho e dithering são aplicados uma única vez por quadro
+    np_dither_ciclo = npColorEncode(leds, np_words, np_dither, LED_COUNT);
+    npDriverStart(&np_drv);
+    return true;
+}
+
+// Conta um período de quadro (contexto de interrupção). O quadro é gerado pela
+// tarefa da animação: leds[], o dithering e o driver só são tocados no loop principal
+bool npAnimTimerCallback(repeating_timer_t *t) {
+    if (!np_anim.running) {
+        np_anim_timer_ativo = false;
+        return false; // Sem animação o temporizador para e não acorda mais o núcleo
+    }
+    np_anim_tiques++;
+    return true;
+}
+
+// Monta a animação "ônibus chegando": o ônibus percorre os padrões 0 a 4,
+// mais rápido quanto menor o tempo restante, e pisca ao chegar
+void npAnimOnibusChegando(uint tempo) {
+    uint16_t passo_ms = 150 + tempo * 10; // 80 min -> 950 ms, 0 min -> 150 ms
+    npAnimStop(&np_anim);
+    npAnimInit(&np_anim, PADRAO_LADO, PADRAO_LADO, true);
+    for (int d = 0; d < 4; d++) {
+        npAnimAddKeyframe(&np_anim, &digits[d][0][0][0], passo_ms, NP_TRANS_FADE, passo_ms / 2);
+    }
+    npAnimAddKeyframe(&np_anim, &digits[4][0][0][0], passo_ms * 3, NP_TRANS_BLINK, passo_ms * 2);
+    np_anim_tempo = tempo;
+    npAnimStart(&np_anim);
+    if (!np_anim_timer_ativo) {
+        np_anim_tiques_lidos = np_anim_tiques; // Tiques de uma animação anterior não contam
+        // Temporizador de taxa fixa (período negativo: entre inícios)
+        np_anim_timer_ativo = add_repeating_timer_us(-NP_ANIM_FRAME_US, npAnimTimerCallback, NULL, &np_anim_timer);
+    }
+}
+
+// Interrompe a animação antes de desenhar padrões estáticos
+void npAnimParar() {
+    npAnimStop(&np_anim);
+}
+
+// Ajusta o brilho global da matriz e reexibe o padrão atual
+void npAjustarBrilho(int delta) {
+    int brilho = npColorGetBrightness() + delta;
+    if (brilho < 0) brilho = 0;
+    if (brilho > 255) brilho = 255;
+    npColorSetBrightness((uint8_t)brilho);
+    mensagem("Brilho da matriz: %d\n", brilho);
+    if (!np_anim.running) {
+        npDisplayDigit(current_digit); // A animação já usa o novo brilho no próximo quadro
+    }
+}
+
+// Lê o sensor de luz ambiente e ajusta o brilho da matriz
+void npLerLuzAmbiente() {
+    adc_select_input(LUZ_AMBIENTE_ADC); // Seleciona o canal do sensor
+    uint16_t luz = adc_read();
+    adc_select_input(0); // Volta ao canal do joystick
+    uint8_t anterior = npColorGetBrightness();
+    npColorSetAmbient(luz);
+    if (npColorGetBrightness() != anterior && !np_anim.running) {
+        npDisplayDigit(current_digit); // Reexibe com o novo brilho
     }
-    sleep_us(100); // Pequeno atraso para estabilizar
 }
 
 // Calcula o índice de um LED na matriz com base em coordenadas (x, y)
 int getIndex(int x, int y) {
-    if (y % 2 == 0) {
-        return 24 - (y * 5 + x); // Linhas pares: ordem direta
-    } else {
-        return 24 - (y * 5 + (4 - x)); // Linhas ímpares: ordem invertida
+    return npGeometryIndex(&np_geo, x, y);
+}
+
+// Lê o ADC do joystick e grava a leitura no trace quando ela muda além da zona morta
+uint16_t ler_adc() {
+    uint16_t valor = adc_read();
+    if (trace.active && abs((int)valor - (int)trace_ultimo_adc) > TRACE_ADC_ZONA_MORTA) {
+        trace_ultimo_adc = valor;
+        registrar_evento(TRACE_EV_ADC, valor);
     }
+    return valor;
+}
+
+// Faixa (0 a 4) de uma leitura do ADC; -1 para leitura nula
+int faixa_adc(uint16_t adc) {
+    if (adc == 0) return -1;
+    if (adc <= 512) return 0;
+    if (adc <= 1024) return 1;
+    if (adc <= 2048) return 2;
+    if (adc <= 3000) return 3;
+    return 4;
+}
+
+// Distância na linha simulada pelo joystick: primeira faixa na origem, última no terminal
+uint32_t distancia_por_faixa(int faixa) {
+    return (uint32_t)((uint64_t)route_length_m(&rota) * faixa / (ADC_FAIXAS - 1));
 }
 
 // Calcula a distância com base na leitura do ADC (simulação)
 float CalcularDistancia() {
-    uint distancia_12bits = adc_read(); // Lê valor ADC (0 a 4096)
-    if (distancia_12bits > 0 && distancia_12bits <= 512) {
-        distancia_global = 0; // Distância 0 km
-    } else if (distancia_12bits > 512 && distancia_12bits <= 1024) {
-        distancia_global = 25; // Distância 25 km
-    } else if (distancia_12bits > 1024 && distancia_12bits <= 2048) {
-        distancia_global = 50; // Distância 50 km
-    } else if (distancia_12bits > 2048 && distancia_12bits <= 3000) {
-        distancia_global = 75; // Distância 75 km
-    } else if (distancia_12bits > 3000 && distancia_12bits <= 4096) {
-        distancia_global = 100; // Distância 100 km
+    int faixa = faixa_adc(ler_adc()); // Lê valor ADC (0 a 4096)
+    if (faixa >= 0) {
+        distancia_global = distancia_por_faixa(faixa); // Posição ao longo da linha
+    }
+    if (faixa == ADC_FAIXAS - 1) {
         gpio_put(BLUE_LED_PIN, 0); // Desliga LED azul
         gpio_put(GREEN_LED_PIN, 1); // Acende LED verde
     }
-    return distancia_global; // Retorna distância calculada
+    return distancia_global / 1000.0f; // Retorna distância calculada (km)
 }
 
-// Calcula o tempo com base na leitura do ADC (simulação)
+// Calcula o tempo até o terminal com base na leitura do ADC (simulação)
 float CalcularTempo() {
-    uint tempo_12bits = adc_read(); // Lê valor ADC (0 a 4096)
-    uint tempo;
-    if (tempo_12bits > 0 && tempo_12bits <= 512) {
-        tempo = 80; // Tempo 80 minutos
-        gpio_put(RED_LED_PIN, 0); // Desliga LED vermelho
-        gpio_put(GREEN_LED_PIN, 0); // Desliga LED verde
-        gpio_put(BLUE_LED_PIN, 1); // Acende LED azul
-    } else if (tempo_12bits > 512 && tempo_12bits <= 1024) {
-        tempo = 60; // Tempo 60 minutos
-        gpio_put(RED_LED_PIN, 0);
-        gpio_put(GREEN_LED_PIN, 0);
-        gpio_put(BLUE_LED_PIN, 1);
-    } else if (tempo_12bits > 1024 && tempo_12bits <= 2048) {
-        tempo = 40; // Tempo 40 minutos
-        gpio_put(RED_LED_PIN, 0);
-        gpio_put(GREEN_LED_PIN, 0);
-        gpio_put(BLUE_LED_PIN, 1);
-    } else if (tempo_12bits > 2048 && tempo_12bits <= 3000) {
-        tempo = 20; // Tempo 20 minutos
-        gpio_put(RED_LED_PIN, 0);
-        gpio_put(BLUE_LED_PIN, 1);
-        gpio_put(GREEN_LED_PIN, 0);
-    } else if (tempo_12bits > 3000 && tempo_12bits <= 4096) {
-        tempo = 0; // Tempo 0 minutos
-        gpio_put(RED_LED_PIN, 0);
-        gpio_put(BLUE_LED_PIN, 0);
-        gpio_put(GREEN_LED_PIN, 1);
-    }
-    return tempo; // Retorna tempo calculado
+    int faixa = faixa_adc(ler_adc()); // Lê valor ADC (0 a 4096)
+    if (faixa < 0) {
+        return tempo_global / 60.0f; // Leitura nula mantém o último tempo
+    }
+    route_position_t pos;
+    route_locate(&rota, distancia_por_faixa(faixa), &pos);
+    tempo_global = pos.eta_end_s; // Horário programado restante até o terminal
+    gpio_put(RED_LED_PIN, 0); // Desliga LED vermelho
+    gpio_put(BLUE_LED_PIN, faixa < ADC_FAIXAS - 1); // Azul enquanto o ônibus não chegou
+    gpio_put(GREEN_LED_PIN, faixa == ADC_FAIXAS - 1); // Verde na chegada
+    return tempo_global / 60.0f; // Retorna tempo calculado (minutos)
 }
 
 // Processa comando para exibir um dígito na matriz de LEDs
-void process_command(int digit, char *line1, uint8_t *ssd, struct render_area *frame_area) {
+void process_command(int digit, char *line1, ssd1306_t *ssd) {
+    npAnimParar(); // Padrão estático substitui a animação
     current_digit = digit; // Define dígito atual
     npDisplayDigit(current_digit); // Exibe dígito na matriz
 }
 
 // Processa comando para exibir distância no display OLED
-void process_command_distancia(char c, char *line1, uint8_t *ssd, struct render_area *frame_area, float distancia) {
-    if (strchr("!@#$", c) != NULL) {
-        sleep_ms(5); // Pequeno atraso para comandos especiais
-    } else {
-        printf("O comando foi %c\n", c); // Exibe comando recebido
+void process_command_distancia(char c, char *line1, ssd1306_t *ssd, float distancia) {
+    if (strchr("!@#$", c) == NULL) {
+        mensagem("O comando foi %c\n", c); // Exibe comando recebido
     }
 
-    memset(ssd, 0, ssd1306_buffer_length); // Limpa buffer do display
-    render_on_display(ssd, frame_area); // Renderiza buffer vazio
+    ssd1306_clear(ssd); // Limpa buffer do display
 
     char distancia_str[32];
     snprintf(distancia_str, sizeof(distancia_str), "%.2f km", distancia); // Formata distância
-    printf("Distancia percorrida do ônibus: %.2f km\n", distancia); // Exibe no terminal
+    mensagem("Distancia percorrida do ônibus: %.2f km\n", distancia); // Exibe no terminal
     ssd1306_draw_string(ssd, 5, 0, line1); // Exibe texto da primeira linha
     ssd1306_draw_string(ssd, 5, 8, distancia_str); // Exibe distância
-    render_on_display(ssd, frame_area); // Renderiza no display
+
+    // Última parada alcançada e a próxima, pela tabela da linha
+    route_position_t pos;
+    char nome[ROUTE_NAME_LEN + 1];
+    char linha[24];
+    route_locate(&rota, distancia_global, &pos);
+    nome_parada(nome, pos.prev);
+    ssd1306_draw_string(ssd, 5, 16, nome);
+    if (pos.next != pos.prev) {
+        nome_parada(nome, pos.next);
+        snprintf(linha, sizeof(linha), "> %s", nome);
+        ssd1306_draw_string(ssd, 5, 24, linha);
+    }
+    agendar_display(); // Envio fica a cargo da tarefa do display
+
+    // Padrão da parada na matriz, se nenhuma animação estiver ocupando-a
+    uint8_t glifo = rota.stops[pos.prev].glyph;
+    if (!np_anim.running && glifo < PADROES) {
+        current_digit = glifo;
+        npDisplayDigit(current_digit);
+    }
 }
 
 // Processa comando para exibir tempo no display OLED
-void process_command_tempo(char c, char *line1, uint8_t *ssd, struct render_area *frame_area, float tempo) {
-    if (strchr("!@#$", c) != NULL) {
-        sleep_ms(5); // Pequeno atraso para comandos especiais
-    } else {
-        printf("O comando foi %c\n", c); // Exibe comando recebido
+void process_command_tempo(char c, char *line1, ssd1306_t *ssd, float tempo) {
+    if (strchr("!@#$", c) == NULL) {
+        mensagem("O comando foi %c\n", c); // Exibe comando recebido
     }
 
-    memset(ssd, 0, ssd1306_buffer_length); // Limpa buffer do display
-    render_on_display(ssd, frame_area); // Renderiza buffer vazio
+    ssd1306_clear(ssd); // Limpa buffer do display
 
     char tempo_str[32];
     snprintf(tempo_str, sizeof(tempo_str), "%.2f minutos", tempo); // Formata tempo
-    printf("Tempo para o ônibus chegar: %.2f minutos\n", tempo); // Exibe no terminal
+    mensagem("Tempo para o ônibus chegar: %.2f minutos\n", tempo); // Exibe no terminal
     ssd1306_draw_string(ssd, 5, 0, line1); // Exibe texto da primeira linha
     ssd1306_draw_string(ssd, 5, 8, tempo_str); // Exibe tempo
-    render_on_display(ssd, frame_area); // Renderiza no display
+
+    // Próxima parada e o tempo programado até ela
+    route_position_t pos;
+    char nome[ROUTE_NAME_LEN + 1];
+    char linha[24];
+    route_locate(&rota, distancia_global, &pos);
+    nome_parada(nome, pos.next);
+    snprintf(linha, sizeof(linha), "> %s", nome);
+    ssd1306_draw_string(ssd, 5, 16, linha);
+    if (pos.next != pos.prev) {
+        snprintf(linha, sizeof(linha), "em %lu min", (unsigned long)((pos.eta_next_s + 59) / 60));
+    } else {
+        snprintf(linha, sizeof(linha), "Terminal");
+    }
+    ssd1306_draw_string(ssd, 5, 24, linha);
+    agendar_display(); // Envio fica a cargo da tarefa do display
+}
+
+// Envia o quadro do display principal a todos os displays. Displays em barramentos
+// diferentes são transmitidos em paralelo.
+void atualizar_displays() {
+#if OLED2_ATIVO
+    // O segundo display espelha as páginas que couberem nele
+    size_t n = oled2.bufsize < oled.bufsize ? oled2.bufsize : oled.bufsize;
+    memcpy(oled2.ram_buffer + 1, oled.ram_buffer + 1, n - 1);
+#endif
+    ssd1306_send_data_multi(oleds, OLED_COUNT);
+}
+
+// Marca o quadro do OLED para envio pela tarefa do display
+void agendar_display() {
+    sched_trigger(&sched, tarefa_display, 0);
 }
 
 // Callback de interrupção para botões
 void gpio_callback(uint gpio, uint32_t events) {
+    registrar_evento(TRACE_EV_BUTTON, gpio); // Grava a borda antes do debounce
     absolute_time_t now = get_absolute_time(); // Obtém tempo atual
     int64_t diff = absolute_time_diff_us(last_interrupt_time, now); // Calcula diferença
     if (diff < 2500) return; // Debounce de 250ms
@@ -355,7 +676,7 @@ void tratar_botoes_e_display() {
         controle3 = !controle3;
         if (controle3) {
             new_data = true;
-            printf("ALARME\n"); // Exibe mensagem de alarme
+            mensagem("ALARME\n"); // Exibe mensagem de alarme
             gpio_put(BLUE_LED_PIN, 0); // Desliga LED azul
             gpio_put(GREEN_LED_PIN, 0); // Desliga LED verde
             gpio_put(RED_LED_PIN, 1); // Acende LED vermelho
@@ -366,9 +687,10 @@ void tratar_botoes_e_display() {
 
 // Exibe um dígito na matriz de LEDs
 void npDisplayDigit(int digit) {
-    for (int coluna = 0; coluna < 5; coluna++) {
-        for (int linha = 0; linha < 5; linha++) {
-            int posicao = getIndex(linha, coluna); // Calcula índice do LED
+    memset(leds, 0, sizeof(leds)); // Apaga a área fora do padrão em matrizes maiores
+    for (int coluna = 0; coluna < PADRAO_LADO; coluna++) {
+        for (int linha = 0; linha < PADRAO_LADO; linha++) {
+            int posicao = getIndex(PADRAO_X + linha, PADRAO_Y + coluna); // Calcula índice do LED
             // Define cores do LED com base na matriz de dígitos
             npSetLED(
                 posicao,
@@ -383,13 +705,24 @@ void npDisplayDigit(int digit) {
 
 // Função principal do programa
 int main() {
+#if IDLE_LOW_CLOCK
+    // UART e I2C passam ao PLL da USB, independentes do clk_sys reduzido no sono
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+    clock_sys_hz = clock_get_hz(clk_sys);
+#endif
     stdio_init_all(); // Inicializa comunicação serial
+    stdio_set_chars_available_callback(serial_disponivel, NULL); // Acorda a tarefa serial
     sleep_ms(1000); // Aguarda 1s para estabilizar
 
+    rota_ativar(); // Tabela gravada na flash ou a linha padrão
+
     // Inicializa ADC para leitura do joystick
     adc_init();
     adc_gpio_init(EIXO_Y); // Configura pino ADC
     adc_select_input(0); // Seleciona canal ADC0
+#if LUZ_AMBIENTE_ATIVA
+    adc_gpio_init(LUZ_AMBIENTE_PIN); // Configura pino do sensor de luz
+#endif
 
     // Inicializa LEDs e buzzer
     init_leds_and_buzzer();
@@ -408,7 +741,7 @@ int main() {
     gpio_pull_up(BOTAO_C_PIN);
 
     // Inicializa matriz de LEDs
-    npInit(LED_PIN);
+    npInit();
 
     // Inicializa I2C para comunicação com o display
     i2c_init(I2C_PORT, ssd1306_i2c_clock * 1000);
@@ -418,19 +751,24 @@ int main() {
     gpio_pull_up(I2C_SCL);
 
     // Inicializa display OLED
-    ssd1306_init();
+    ssd1306_init_bm(&oled, ssd1306_width, OLED_ALTURA, false, ssd1306_i2c_address, I2C_PORT);
+    ssd1306_config(&oled);
+    oleds[0] = &oled;
 
-    // Configura área de renderização do display
-    uint8_t ssd[ssd1306_buffer_length]; // Buffer do display
-    struct render_area frame_area = {
-        .start_column = 0,
-        .end_column = ssd1306_width - 1,
-        .start_page = 0,
-        .end_page = ssd1306_n_pages - 1
-    };
-    calculate_render_area_buffer_length(&frame_area); // Calcula tamanho do buffer
-    memset(ssd, 0, ssd1306_buffer_length); // Limpa buffer
-    render_on_display(ssd, &frame_area); // Renderiza display vazio
+#if OLED2_ATIVO
+    // Segundo display no outro barramento
+    i2c_init(OLED2_I2C_PORT, ssd1306_i2c_clock * 1000);
+    gpio_set_function(OLED2_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(OLED2_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(OLED2_SDA);
+    gpio_pull_up(OLED2_SCL);
+    ssd1306_init_bm(&oled2, ssd1306_width, OLED2_ALTURA, false, ssd1306_i2c_address, OLED2_I2C_PORT);
+    ssd1306_config(&oled2);
+    oleds[1] = &oled2;
+#endif
+
+    ssd1306_clear(&oled); // Limpa buffer
+    atualizar_displays(); // Renderiza displays vazios
 
     // Configura interrupções para os botões
     gpio_set_irq_enabled(BOTAO_A_PIN, GPIO_IRQ_EDGE_FALL, true);
@@ -439,30 +777,569 @@ int main() {
     gpio_set_irq_callback(gpio_callback); // Define callback de interrupção
     irq_set_enabled(IO_IRQ_BANK0, true); // Ativa interrupções GPIO
 
-    // Loop principal
+    // Tarefas do firmware
+    sched_init(&sched, time_us_64);
+    tarefa_entrada_botoes = sched_add_periodic(&sched, "botoes", tarefa_botoes, NULL, BOTOES_PERIODO_US, BOTOES_PERIODO_US, PRIORIDADE_ENTRADA);
+    tarefa_entrada_serial = sched_add_periodic(&sched, "serial", tarefa_serial, NULL, SERIAL_PERIODO_US, SERIAL_PERIODO_US, PRIORIDADE_ENTRADA);
+    tarefa_amostragem = sched_add_periodic(&sched, "sensores", tarefa_sensores, NULL, SENSORES_PERIODO_US, SENSORES_PERIODO_US, PRIORIDADE_SENSORES);
+    tarefa_display = sched_add_oneshot(&sched, "display", tarefa_enviar_display, NULL, DISPLAY_PRAZO_US, PRIORIDADE_DISPLAY);
+    tarefa_buzzer = sched_add_oneshot(&sched, "alarme", tarefa_desligar_buzzer, NULL, BUZZER_PRAZO_US, PRIORIDADE_ALARME);
+    tarefa_animacao = sched_add_oneshot(&sched, "animacao", tarefa_animar_matriz, NULL, ANIM_PRAZO_US, PRIORIDADE_DISPLAY);
+    tarefa_dither = sched_add_periodic(&sched, "dither", tarefa_reenviar_matriz, NULL, DITHER_PERIODO_US, DITHER_PERIODO_US, PRIORIDADE_SENSORES);
+    tarefa_telem = sched_add_periodic(&sched, "telem", tarefa_telemetria, NULL, TELEMETRIA_PERIODO_US, TELEMETRIA_PERIODO_US, PRIORIDADE_SENSORES);
+    tarefa_telem_envio = sched_add_periodic(&sched, "usb_tx", tarefa_enviar_telemetria, NULL, TELEMETRIA_ENVIO_US, TELEMETRIA_ENVIO_US, PRIORIDADE_SENSORES);
+    if (np_dither_restantes == 0) {
+        sched_cancel(&sched, tarefa_dither); // Só roda enquanto um quadro parado fecha o ciclo
+    }
+    sched_cancel(&sched, tarefa_telem); // Telemetria começa desligada ('t')
+    sched_cancel(&sched, tarefa_telem_envio);
+
+    // Monitor do loop: a partir daqui o watchdog reinicia a placa se uma tarefa travar
+    loop_monitor_init(&loop_mon, LOOP_ORCAMENTO_US);
+    loop_monitor_reset_idle(&loop_mon, time_us_64());
+    sched_set_hooks(&sched, monitor_inicio_tarefa, monitor_fim_tarefa, &loop_mon);
+    loop_monitor_arm_watchdog(&loop_mon, WATCHDOG_TIMEOUT_MS);
+    if (loop_mon.reset_stage != LOOP_MON_NONE) {
+        mensagem("Reset pelo watchdog durante '%s' (%lu seguidos)\n",
+                 nome_estagio(loop_mon.reset_stage), (unsigned long)loop_mon.resets);
+    }
+
+    // Loop principal: executa a tarefa liberada mais urgente ou dorme até a próxima
     while (true) {
-        sleep_ms(50); // Atraso para estabilizar o sistema
-        tratar_botoes_e_display(); // Processa eventos de botões
-        uint tempo = CalcularTempo(); // Calcula tempo (usado para LEDs)
-
-        // Verifica entrada de comandos via terminal
-        int input = getchar_timeout_us(0); // Lê caractere sem bloqueio
-        if (input != PICO_ERROR_TIMEOUT || new_data) {
-            if (!new_data) {
-                c = (char)input; // Converte entrada para char
+        loop_monitor_pass(&loop_mon, time_us_64()); // Mede o período e alimenta o watchdog
+        despachar_eventos();
+        if (!sched_run_once(&sched)) {
+            ocioso_aguardar();
+        }
+    }
+}
+
+// Tarefa: trata eventos de botões
+void tarefa_botoes(void *arg) {
+    tratar_botoes_e_display();
+    if (new_data) {
+        sched_trigger(&sched, tarefa_entrada_serial, 0); // O comando do botão é executado pela tarefa serial
+    }
+}
+
+// Tarefa: verifica entrada de comandos via terminal ou botões
+void tarefa_serial(void *arg) {
+    int input = ler_serial(); // Lê caractere sem bloqueio
+    if (rota_carregando) {
+        if (input == PICO_ERROR_TIMEOUT && time_us_64() - rota_carga_us > ROTA_CARGA_TIMEOUT_US) {
+            rota_cancelar_carga("Carga abandonada por inatividade"); // Volta a aceitar comandos
+            return;
+        }
+        // Carga da tabela: consome a entrada disponível de uma vez
+        for (int n = 1; input != PICO_ERROR_TIMEOUT; n++) {
+            rota_receber((char)input);
+            if (!rota_carregando) {
+                break;
             }
-            // Processa comandos recebidos
-            switch (c) {
-                case '0': process_command(0, "numero", ssd, &frame_area); break; // Exibe dígito 0
-                case '1': process_command(1, "numero", ssd, &frame_area); break; // Exibe dígito 1
-                case '2': process_command(2, "numero", ssd, &frame_area); break; // Exibe dígito 2
-                case '3': process_command(3, "numero", ssd, &frame_area); break; // Exibe dígito 3
-                case '4': process_command(4, "numero", ssd, &frame_area); break; // Exibe dígito 4
-                case '!': process_command_distancia(c, "Distancia", ssd, &frame_area, CalcularDistancia()); break; // Exibe distância
-                case '#': process_command_tempo(c, "Tempo restante", ssd, &frame_area, CalcularTempo()); break; // Exibe tempo
-                case '~': break; // Comando nulo (nenhuma ação)
+            if (n == ROTA_CARGA_POR_TAREFA) {
+                sched_trigger(&sched, tarefa_entrada_serial, 0); // Continua na próxima execução
+                break;
             }
-            new_data = false; // Reseta flag de novo comando
+            input = ler_serial();
+        }
+        return;
+    }
+    if (input != PICO_ERROR_TIMEOUT || new_data) {
+        if (!new_data) {
+            c = (char)input; // Converte entrada para char
+        }
+        executar_comando(c, &oled);
+        new_data = false; // Reseta flag de novo comando
+    }
+    if (input != PICO_ERROR_TIMEOUT) {
+        sched_trigger(&sched, tarefa_entrada_serial, 0); // Um comando por vez; pode haver mais na fila
+    }
+}
+
+// Tarefa: amostra o ADC, atualiza LEDs RGB, brilho e animação
+void tarefa_sensores(void *arg) {
+    uint tempo = CalcularTempo(); // Calcula tempo (usado para LEDs)
+#if LUZ_AMBIENTE_ATIVA
+    npLerLuzAmbiente(); // Ajusta o brilho da matriz pela luz ambiente
+#endif
+    // Acelera a animação conforme o tempo de chegada diminui
+    if (np_anim.running && tempo != np_anim_tempo) {
+        npAnimOnibusChegando(tempo);
+    }
+    // Leituras estáveis: espaça a amostragem para o núcleo dormir mais
+    if (tempo == sensores_ultimo_tempo) {
+        if (sensores_estaveis < SENSORES_ESTAVEL && ++sensores_estaveis == SENSORES_ESTAVEL) {
+            sched_set_period(&sched, tarefa_amostragem, SENSORES_OCIOSO_US);
+        }
+    } else {
+        if (sensores_estaveis >= SENSORES_ESTAVEL) {
+            sched_set_period(&sched, tarefa_amostragem, SENSORES_PERIODO_US);
+        }
+        sensores_estaveis = 0;
+    }
+    sensores_ultimo_tempo = tempo;
+}
+
+// Tarefa: amostra o ADC e enfileira um registro a cada telem_decimacao amostras
+void tarefa_telemetria(void *arg) {
+    uint16_t bruto = ler_adc();
+    uint16_t filtrado = telemetry_filter(&telem, bruto);
+    if (!telemetry_due(&telem)) {
+        return;
+    }
+    int faixa = faixa_adc(filtrado);
+    route_position_t pos = {0};
+    uint32_t distancia = faixa >= 0 ? distancia_por_faixa(faixa) : 0;
+    route_locate(&rota, distancia, &pos);
+    telemetry_record_t rec = {
+        .time_ms = (uint32_t)(time_us_64() / 1000),
+        .adc_raw = bruto,
+        .adc_filtered = filtrado,
+        .distance_m = distancia,
+        .eta_s = (uint16_t)(pos.eta_end_s > UINT16_MAX ? UINT16_MAX : pos.eta_end_s),
+        .flags = (controle3 ? TELEMETRY_FLAG_ALARM : 0) |
+                 (np_anim.running ? TELEMETRY_FLAG_ANIM : 0) |
+                 (trace.active ? TELEMETRY_FLAG_TRACE : 0)
+    };
+    telemetry_push(&telem, &rec); // Fila cheia: descarta e marca perda no próximo
+}
+
+// Tarefa: drena a fila de telemetria para a USB CDC sem bloquear.
+// O pico_stdio_usb roda tud_task() numa interrupção de fundo; com as interrupções
+// desligadas durante a escrita e o flush, ela não encontra a FIFO da CDC pela metade.
+void tarefa_enviar_telemetria(void *arg) {
+    uint32_t estado = save_and_disable_interrupts();
+    if (!tud_cdc_connected()) {
+        restore_interrupts(estado);
+        return; // Sem terminal: a fila enche e os excedentes são descartados
+    }
+    const uint8_t *p;
+    size_t n;
+    bool enviou = false;
+    while ((n = telemetry_peek(&telem, &p)) > 0) {
+        uint32_t livre = tud_cdc_write_available();
+        if (livre == 0) {
+            break; // FIFO da USB cheia; continua na próxima execução
+        }
+        n = tud_cdc_write(p, n < livre ? n : livre);
+        telemetry_consume(&telem, n);
+        enviou = true;
+    }
+    if (enviou) {
+        tud_cdc_write_flush();
+    }
+    restore_interrupts(estado);
+}
+
+// Tarefa: reenvia o quadro parado da matriz até fechar o ciclo do dithering e então
+// se desarma; a animação já gera quadros por conta própria
+void tarefa_reenviar_matriz(void *arg) {
+    if (np_dither_restantes == 0 || np_anim.running) {
+        sched_cancel(&sched, tarefa_dither);
+        return;
+    }
+    if (npShow(false)) {
+        np_dither_restantes--;
+    }
+}
+
+// Tarefa: avança a animação pelos períodos contados pelo temporizador e envia o quadro.
+// Períodos perdidos com o loop ocupado são avançados juntos, sem atrasar a linha do tempo.
+void tarefa_animar_matriz(void *arg) {
+    uint32_t tiques = np_anim_tiques;
+    uint32_t periodos = tiques - np_anim_tiques_lidos;
+    np_anim_tiques_lidos = tiques;
+    if (!np_anim.running || periodos == 0) {
+        return;
+    }
+    npAnimAdvance(&np_anim, periodos * NP_ANIM_FRAME_US);
+    npAnimRender(&np_anim, np_anim_rgb);
+    for (int y = 0; y < PADRAO_LADO; y++) {
+        for (int x = 0; x < PADRAO_LADO; x++) {
+            const uint8_t *rgb = &np_anim_rgb[(y * PADRAO_LADO + x) * 3];
+            npSetLED(getIndex(PADRAO_X + x, PADRAO_Y + y), rgb[0], rgb[1], rgb[2]);
+        }
+    }
+    npShow(false); // Descarta o quadro se o anterior ainda estiver no fio
+}
+
+// Tarefa: envia o quadro pendente aos displays
+void tarefa_enviar_display(void *arg) {
+    atualizar_displays();
+}
+
+// Tarefa: desliga o buzzer ao fim do alarme
+void tarefa_desligar_buzzer(void *arg) {
+    stop_buzzer(BUZZER_PIN);
+}
+
+// Processa comandos recebidos
+void executar_comando(char c, ssd1306_t *ssd) {
+    switch (c) {
+        case '0': process_command(0, "numero", ssd); break; // Exibe dígito 0
+        case '1': process_command(1, "numero", ssd); break; // Exibe dígito 1
+        case '2': process_command(2, "numero", ssd); break; // Exibe dígito 2
+        case '3': process_command(3, "numero", ssd); break; // Exibe dígito 3
+        case '4': process_command(4, "numero", ssd); break; // Exibe dígito 4
+        case '!': process_command_distancia(c, "Distancia", ssd, CalcularDistancia()); break; // Exibe distância
+        case '#': process_command_tempo(c, "Tempo restante", ssd, CalcularTempo()); break; // Exibe tempo
+        case '+': npAjustarBrilho(BRILHO_PASSO); break; // Aumenta brilho da matriz
+        case '-': npAjustarBrilho(-BRILHO_PASSO); break; // Diminui brilho da matriz
+        case 'a': npAnimOnibusChegando(CalcularTempo()); break; // Animação "ônibus chegando"
+        case 's': imprimir_estatisticas(); break; // Estatísticas das tarefas
+        case 'r': trace_iniciar(); break; // Inicia gravação de eventos
+        case 'R': trace_parar(); break; // Encerra gravação de eventos
+        case 'd': trace_despejar(); break; // Envia o trace em hexadecimal
+        case 'p': imprimir_rota(); break; // Lista as paradas da linha
+        case 'L': rota_iniciar_carga(); break; // Recebe uma nova tabela de paradas
+        case 'u': imprimir_utilizacao(); break; // Tempo ocupado e ocioso da CPU
+        case 'h': imprimir_histograma(); break; // Histogramas do loop e estouros
+        case 't': telemetria_alternar(); break; // Liga/desliga a telemetria binária
+        case '>': telemetria_taxa(-1); break; // Dobra a taxa de registros
+        case '<': telemetria_taxa(1); break; // Reduz a taxa de registros pela metade
+        case '~': break; // Comando nulo (nenhuma ação)
+    }
+}
+
+// Exibe execuções, prazos perdidos e tempos de cada tarefa
+void imprimir_estatisticas() {
+    mensagem("tarefa     exec  perdidos  ult_us  max_us  med_us  atraso_max_us\n");
+    for (uint8_t i = 0; i < sched.count; i++) {
+        const sched_task_t *t = &sched.tasks[i];
+        uint32_t media = t->runs ? (uint32_t)(t->total_us / t->runs) : 0;
+        mensagem("%-9s %6lu %9lu %7lu %7lu %7lu %14lu\n", t->name,
+               (unsigned long)t->runs, (unsigned long)t->misses, (unsigned long)t->last_us,
+               (unsigned long)t->max_us, (unsigned long)media, (unsigned long)t->max_late_us);
+    }
+    sched_reset_stats(&sched);
+}
+
+// Grava um evento de entrada; seguro em interrupções e no loop principal
+void registrar_evento(uint8_t tipo, uint32_t valor) {
+    uint32_t estado = save_and_disable_interrupts();
+    trace_record(&trace, time_us_64(), tipo, valor);
+    restore_interrupts(estado);
+}
+
+// Descarta a gravação anterior e começa a gravar eventos de entrada
+void trace_iniciar() {
+    uint32_t estado = save_and_disable_interrupts();
+    trace_init(&trace, trace_buf, sizeof(trace_buf));
+    trace_start(&trace, time_us_64());
+    trace_ultimo_adc = 0xFFFF; // Força gravar a próxima leitura do ADC
+    restore_interrupts(estado);
+    mensagem("Gravando eventos (%u bytes)\n", TRACE_BUF_BYTES);
+}
+
+// Encerra a gravação
+void trace_parar() {
+    trace_stop(&trace);
+    mensagem("Trace: %lu eventos, %u bytes%s\n", (unsigned long)trace.count, (uint)trace.len,
+           trace.overflow ? " (buffer cheio)" : "");
+}
+
+// Envia o trace em linhas "TRACE <hex>", lidas pelo tools/replay
+void trace_despejar() {
+    mensagem("TRACE BEGIN %u\n", (uint)trace.len);
+    for (size_t i = 0; i < trace.len; i += TRACE_DUMP_LINHA) {
+        mensagem("TRACE ");
+        for (size_t j = i; j < trace.len && j < i + TRACE_DUMP_LINHA; j++) {
+            mensagem("%02x", trace_buf[j]);
+        }
+        mensagem("\n");
+    }
+    mensagem("TRACE END\n");
+}
+
+// printf que se cala durante a telemetria binária, para não corromper o fluxo
+int mensagem(const char *fmt, ...) {
+    if (telemetria_ativa) {
+        return 0;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vprintf(fmt, args);
+    va_end(args);
+    return n;
+}
+
+// Alterna entre mensagens de texto e registros binários de telemetria
+void telemetria_alternar() {
+    if (telemetria_ativa) {
+        sched_cancel(&sched, tarefa_telem);
+        sched_cancel(&sched, tarefa_telem_envio);
+        telemetria_ativa = false;
+        mensagem("Telemetria: %lu registros, %lu descartados\n",
+                 (unsigned long)telem.queued, (unsigned long)telem.dropped);
+        return;
+    }
+    mensagem("Telemetria binaria: %u registros/s ('t' encerra)\n",
+             (uint)(1000000 / (TELEMETRIA_PERIODO_US * telem_decimacao)));
+    telemetry_init(&telem, telem_fila, sizeof(telem_fila), telem_decimacao, TELEMETRIA_FILTRO);
+    telemetria_ativa = true;
+    sched_trigger(&sched, tarefa_telem, 0);
+    sched_trigger(&sched, tarefa_telem_envio, 0);
+}
+
+// Ajusta a decimação: fator < 0 dobra a taxa de registros, fator > 0 reduz à metade
+void telemetria_taxa(int fator) {
+    if (fator < 0 && telem_decimacao > 1) {
+        telem_decimacao /= 2;
+    } else if (fator > 0 && telem_decimacao * 2 <= TELEMETRIA_DECIMACAO_MAX) {
+        telem_decimacao *= 2;
+    }
+    telemetry_set_decimation(&telem, telem_decimacao);
+    mensagem("Telemetria: %u registros/s\n", (uint)(1000000 / (TELEMETRIA_PERIODO_US * telem_decimacao)));
+}
+
+// Gancho do escalonador: registra a tarefa que vai rodar
+void monitor_inicio_tarefa(void *ctx, uint8_t id) {
+    loop_monitor_stage_begin((loop_monitor_t *)ctx, id);
+}
+
+// Gancho do escalonador: atraso de início e duração da tarefa que terminou
+void monitor_fim_tarefa(void *ctx, uint8_t id, uint32_t atraso_us, uint32_t execucao_us) {
+    loop_monitor_stage_end((loop_monitor_t *)ctx, id, atraso_us, execucao_us);
+}
+
+// Nome de um estágio do monitor (tarefa do escalonador ou o próprio loop)
+const char *nome_estagio(uint8_t estagio) {
+    if (estagio < sched.count) {
+        return sched.tasks[estagio].name;
+    }
+    return estagio == LOOP_MON_IDLE ? "loop" : "-";
+}
+
+// Exibe os histogramas de período do loop e atraso das tarefas e os estouros de orçamento
+void imprimir_histograma() {
+    mensagem("faixa_us          periodo    atraso\n");
+    for (uint8_t k = 0; k < LOOP_MON_BUCKETS; k++) {
+        if (loop_mon.period_hist[k] == 0 && loop_mon.jitter_hist[k] == 0) {
+            continue;
         }
+        unsigned long inicio = k ? 1ul << k : 0;
+        if (k == LOOP_MON_BUCKETS - 1) {
+            mensagem("%7lu+         ", inicio);
+        } else {
+            mensagem("%7lu-%-7lu  ", inicio, (2ul << k) - 1);
+        }
+        mensagem("%9lu %9lu\n", (unsigned long)loop_mon.period_hist[k], (unsigned long)loop_mon.jitter_hist[k]);
+    }
+    mensagem("Iteracoes: %lu, pior: %lu us (%s), orcamento: %lu us\n",
+             (unsigned long)loop_mon.iterations, (unsigned long)loop_mon.worst_us,
+             nome_estagio(loop_mon.worst_stage), (unsigned long)loop_mon.budget_us);
+    for (uint8_t i = 0; i < sched.count && i < LOOP_MON_STAGES; i++) {
+        if (loop_mon.overruns[i]) {
+            mensagem("Estouros em %s: %lu\n", sched.tasks[i].name, (unsigned long)loop_mon.overruns[i]);
+        }
+    }
+    if (loop_mon.last_overrun_stage != LOOP_MON_NONE) {
+        mensagem("Ultimo estouro: %s, %lu us\n", nome_estagio(loop_mon.last_overrun_stage),
+                 (unsigned long)loop_mon.last_overrun_us);
+    }
+    if (loop_mon.reset_stage != LOOP_MON_NONE) {
+        mensagem("Ultimo reset pelo watchdog: %s\n", nome_estagio(loop_mon.reset_stage));
+    }
+    loop_monitor_reset_stats(&loop_mon);
+}
+
+// Copia o nome de uma parada (o nome pode ocupar os 16 bytes sem '\0')
+void nome_parada(char *destino, uint16_t indice) {
+    memcpy(destino, rota.stops[indice].name, ROUTE_NAME_LEN);
+    destino[ROUTE_NAME_LEN] = '\0';
+}
+
+// Ativa a tabela gravada na flash ou, se ela estiver ausente ou corrompida, a linha padrão
+void rota_ativar() {
+    if (!route_open(&rota, ROTA_FLASH, FLASH_SECTOR_SIZE)) {
+        route_use(&rota, rota_padrao, count_of(rota_padrao));
+    }
+}
+
+// Apaga o setor da tabela; a flash não pode ser lida (XIP) durante a operação
+void rota_apagar() {
+    uint32_t estado = save_and_disable_interrupts();
+    flash_range_erase(ROTA_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    restore_interrupts(estado);
+}
+
+// Grava uma página de 256 bytes da imagem recebida
+void rota_gravar_pagina(uint32_t offset, const uint8_t *pagina) {
+    uint32_t estado = save_and_disable_interrupts();
+    flash_range_program(ROTA_FLASH_OFFSET + offset, pagina, ROUTE_PAGE_LEN);
+    restore_interrupts(estado);
+}
+
+// Comando 'L': apaga a tabela atual e passa a tratar a serial como a imagem em hexadecimal
+void rota_iniciar_carga() {
+    route_use(&rota, rota_padrao, count_of(rota_padrao)); // A tabela na flash vai ser apagada
+    rota_apagar();
+    route_loader_begin(&rota_carga, rota_gravar_pagina);
+    rota_nibble = -1;
+    rota_carregando = true;
+    rota_carga_us = time_us_64();
+    mensagem("Envie a tabela em hexadecimal ('q' cancela, ate %u paradas)\n", (uint)ROUTE_MAX_STOPS);
+}
+
+// Sai do modo de carga; a tabela parcial é apagada e vale a linha padrão
+void rota_cancelar_carga(const char *motivo) {
+    rota_carregando = false;
+    rota_apagar();
+    mensagem("%s, usando a linha padrao\n", motivo);
+}
+
+// Recebe um caractere da imagem; caracteres que não são hexadecimais são ignorados
+void rota_receber(char ch) {
+    rota_carga_us = time_us_64();
+    if (ch == 'q') {
+        rota_cancelar_carga("Carga cancelada");
+        return;
+    }
+    if (!isxdigit((unsigned char)ch)) {
+        return;
+    }
+    int valor = isdigit((unsigned char)ch) ? ch - '0' : tolower((unsigned char)ch) - 'a' + 10;
+    if (rota_nibble < 0) {
+        rota_nibble = valor;
+        return;
+    }
+    int estado = route_loader_feed(&rota_carga, (uint8_t)(rota_nibble << 4 | valor));
+    rota_nibble = -1;
+    if (estado == ROUTE_LOAD_MORE) {
+        return;
+    }
+    rota_carregando = false;
+    if (estado == ROUTE_LOAD_DONE && route_open(&rota, ROTA_FLASH, FLASH_SECTOR_SIZE)) {
+        mensagem("Linha carregada: %u paradas, %lu m\n", (uint)rota.count, (unsigned long)route_length_m(&rota));
+    } else {
+        rota_apagar();
+        mensagem("Tabela invalida, usando a linha padrao\n");
+    }
+}
+
+// Lista as paradas e a posição atual na linha
+void imprimir_rota() {
+    route_position_t pos;
+    char nome[ROUTE_NAME_LEN + 1];
+    route_locate(&rota, distancia_global, &pos);
+    mensagem("  parada             dist_m  horario_s  padrao\n");
+    for (uint16_t i = 0; i < rota.count; i++) {
+        nome_parada(nome, i);
+        mensagem("%c %-16s %8lu %10u %7u\n", i == pos.prev ? '*' : ' ', nome,
+                 (unsigned long)rota.stops[i].distance_m, (uint)rota.stops[i].offset_s, (uint)rota.stops[i].glyph);
+    }
+    nome_parada(nome, pos.next);
+    mensagem("Proxima: %s em %lu m (%lu s); terminal em %lu s\n", nome, (unsigned long)pos.to_next_m,
+             (unsigned long)pos.eta_next_s, (unsigned long)pos.eta_end_s);
+}
+
+// Callback do stdio (interrupção da USB ou UART): há caracteres para ler
+void serial_disponivel(void *param) {
+    serial_receber();
+    serial_pendente = true;
+}
+
+// Move os caracteres disponíveis para a fila, gravando no trace o instante de chegada.
+// Com a fila cheia, o restante espera no buffer do stdio.
+void serial_receber() {
+    while (serial_recebidos - serial_lidos < SERIAL_FILA_BYTES) {
+        int ch = getchar_timeout_us(0);
+        if (ch == PICO_ERROR_TIMEOUT) {
+            break;
+        }
+        registrar_evento(TRACE_EV_SERIAL, (uint8_t)ch);
+        serial_fila[serial_recebidos % SERIAL_FILA_BYTES] = (uint8_t)ch;
+        serial_recebidos++;
+    }
+}
+
+// Próximo caractere recebido, ou PICO_ERROR_TIMEOUT se não houver
+int ler_serial() {
+    if (serial_lidos == serial_recebidos) {
+        // Fila vazia: recolhe o que ficou no stdio enquanto ela estava cheia
+        uint32_t estado = save_and_disable_interrupts();
+        serial_receber();
+        restore_interrupts(estado);
+        if (serial_lidos == serial_recebidos) {
+            return PICO_ERROR_TIMEOUT;
+        }
+    }
+    int ch = serial_fila[serial_lidos % SERIAL_FILA_BYTES];
+    serial_lidos++;
+    return ch;
+}
+
+// Dispara as tarefas de entrada sinalizadas pelas interrupções
+void despachar_eventos() {
+    if (botao_pressionado) {
+        sched_trigger(&sched, tarefa_entrada_botoes, 0);
+    }
+    if (serial_pendente) {
+        serial_pendente = false;
+        sched_trigger(&sched, tarefa_entrada_serial, 0);
+    }
+    if (np_anim_tiques != np_anim_tiques_lidos) {
+        sched_trigger(&sched, tarefa_animacao, 0);
+    }
+}
+
+// Dorme até a próxima liberação de tarefa. Interrupções (temporizador da animação,
+// botões, USB) acordam o núcleo antes; o loop então despacha o evento.
+void ocioso_aguardar() {
+    uint64_t inicio = time_us_64();
+    uint64_t acordar = sched_next_release(&sched);
+    if (acordar <= inicio || botao_pressionado || serial_pendente || np_anim_tiques != np_anim_tiques_lidos) {
+        return;
+    }
+    if (acordar - inicio > OCIOSO_MAX_US) {
+        acordar = inicio + OCIOSO_MAX_US;
+    }
+    bool baixo = IDLE_LOW_CLOCK && acordar - inicio >= OCIOSO_CLOCK_BAIXO_US && clock_baixo_permitido();
+    if (baixo) {
+        clock_reduzir();
+    }
+    best_effort_wfe_or_timeout(from_us_since_boot(acordar));
+    if (baixo) {
+        clock_restaurar();
+    }
+    loop_monitor_idle(&loop_mon, (uint32_t)(time_us_64() - inicio), baixo);
+}
+
+// PIO e PWM dependem do clk_sys: só reduz com a matriz parada e o buzzer desligado
+bool clock_baixo_permitido() {
+    return !npDriverBusy(&np_drv) && !np_anim.running && !sched.tasks[tarefa_buzzer].active;
+}
+
+// Divide o clk_sys; UART e I2C seguem no PLL da USB (configurado no início)
+void clock_reduzir() {
+#if IDLE_LOW_CLOCK
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, clock_sys_hz, clock_sys_hz / OCIOSO_DIVISOR);
+#endif
+}
+
+// Volta ao clk_sys nominal: os divisores do PIO (WS2812B) e do PWM (buzzer) voltam a
+// gerar as frequências configuradas sem precisar ser reprogramados
+void clock_restaurar() {
+#if IDLE_LOW_CLOCK
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, clock_sys_hz, clock_sys_hz);
+#endif
+}
+
+// Exibe a fração do tempo ocupado e ocioso desde a última consulta
+void imprimir_utilizacao() {
+    uint64_t janela = time_us_64() - loop_mon.window_us;
+    if (janela == 0) {
+        return;
     }
+    uint32_t ocioso = (uint32_t)(loop_mon.idle_us * 1000 / janela);
+    uint32_t baixo = (uint32_t)(loop_mon.low_clock_us * 1000 / janela);
+    mensagem("CPU: ocupada %lu.%lu%%, ociosa %lu.%lu%% (clock baixo %lu.%lu%%) em %lu ms\n",
+             (unsigned long)(1000 - ocioso) / 10, (unsigned long)(1000 - ocioso) % 10,
+             (unsigned long)ocioso / 10, (unsigned long)ocioso % 10,
+             (unsigned long)baixo / 10, (unsigned long)baixo % 10, (unsigned long)(janela / 1000));
+    mensagem("Despertares: %lu (%lu/s)\n", (unsigned long)loop_mon.sleeps,
+             (unsigned long)(loop_mon.sleeps * 1000000ull / janela));
+    loop_monitor_reset_idle(&loop_mon, time_us_64());
 }
\ No newline at end of file
@@ -0,0 +1,353 @@
+// Microbenchmarks dos caminhos quentes de desenho, codificação e quantização do ADC.
+//
+// Uso:
+//   bench [--json] [--base arquivo] [--tolerancia pct] [--apenas-bytes] [--gravar arquivo]
+//
+// Cada caso executa a função do firmware (compilado para o host sobre o SDK simulado)
+// até somar um tempo mínimo e guarda a melhor de várias rodadas. O relatório traz
+// ns/op e bytes gerados por operação (I2C do OLED ou quadro das fitas WS2812B).
+// Com --base, um caso mais lento que a linha de base além da tolerância (padrão 25%)
+// ou que gere mais bytes por operação é uma regressão e o programa sai com 1.
+// O tempo só é comparável de perto na máquina que gravou a base; o ctest roda o teste
+// "bench" com --apenas-bytes (só bytes por operação, determinísticos) e o "bench_tempo"
+// com tolerância de 200%, que só pega regressões grosseiras de tempo.
+// --gravar escreve os resultados no formato da linha de base.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "inc/ssd1306.h"
+#include "inc/np_color.h"
+#include "inc/np_geometry.h"
+#include "sim.h"
+
+#undef printf // A saída do benchmark vai para o terminal, não para a USB simulada
+
+#define BENCH_RODADAS 7             // Rodadas por caso; vale a mais rápida
+#define BENCH_RODADA_NS 10000000ull // Duração mínima de uma rodada (10 ms)
+#define BENCH_MAX_CASOS 32
+#define BENCH_NOME_LEN 48
+#define BENCH_TOLERANCIA 25.0       // Folga padrão sobre a linha de base (%)
+
+// Funções e estado do firmware (neopixel_pio.c)
+extern ssd1306_t oled;
+void npInit();
+void npDisplayDigit(int digit);
+int getIndex(int x, int y);
+int faixa_adc(uint16_t adc);
+float CalcularDistancia();
+float CalcularTempo();
+void rota_ativar();
+
+extern uint64_t bench_bytes;        // Contador dos transportes nulos (bench_drivers.c)
+
+typedef struct {
+    const char *nome;
+    uint32_t ops;                   // Operações por chamada de rodar()
+    void (*rodar)(void);
+} caso_t;
+
+typedef struct {
+    char nome[BENCH_NOME_LEN];
+    double ns_op;
+    double bytes_op;
+} resultado_t;
+
+static volatile int sumidouro;      // Impede que o compilador descarte resultados
+
+// Linhas e textos fixos, gerados uma vez
+#define BENCH_LINHAS 32
+static int linhas[BENCH_LINHAS][4];
+static const char *textos[] = {
+    "Distancia: 50 km", "Tempo: 40.00 min", "Prox: Parada 3", "ALARME",
+    "Rodoviaria", "0123456789", "Parada 1 -> 2", "ETA 12 min"
+};
+
+static const np_geometry_t geo_32x32 = {
+    .panel_width = 16,
+    .panel_height = 16,
+    .tiles_x = 2,
+    .tiles_y = 2,
+    .serpentine = true,
+    .tile_serpentine = true,
+    .rotation = NP_ROT_90
+};
+static pixel_t pixels_16x16[256];
+static uint32_t palavras_16x16[256];
+static uint8_t dither_16x16[256 * 3];
+
+static void rodar_set_pixel(void) {
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 128; x++) {
+            ssd1306_set_pixel(&oled, x, y, (x ^ y) & 1);
+        }
+    }
+}
+
+static void rodar_draw_line(void) {
+    for (int i = 0; i < BENCH_LINHAS; i++) {
+        ssd1306_draw_line(&oled, linhas[i][0], linhas[i][1], linhas[i][2], linhas[i][3], true);
+    }
+}
+
+static void rodar_draw_string(void) {
+    for (unsigned i = 0; i < count_of(textos); i++) {
+        ssd1306_draw_string(&oled, 0, (int16_t)(i * 8), textos[i]);
+    }
+}
+
+static void rodar_render_total(void) {
+    struct render_area area = { .start_column = 0, .end_column = 127, .start_page = 0, .end_page = 7 };
+    calculate_render_area_buffer_length(&area);
+    render_on_display(&oled, &area);
+}
+
+// Linha de valor do OLED: duas páginas, sem as margens
+static void rodar_render_parcial(void) {
+    struct render_area area = { .start_column = 5, .end_column = 122, .start_page = 2, .end_page = 3 };
+    calculate_render_area_buffer_length(&area);
+    render_on_display(&oled, &area);
+}
+
+// Quadro completo como o da tarefa de display: limpa, escreve e envia
+static void rodar_quadro_oled(void) {
+    ssd1306_clear(&oled);
+    ssd1306_draw_string(&oled, 5, 0, "Distancia");
+    ssd1306_draw_string(&oled, 5, 16, "50.00 km");
+    ssd1306_draw_string(&oled, 5, 32, "Prox: Parada 3");
+    ssd1306_send_data(&oled);
+}
+
+static void rodar_get_index(void) {
+    for (int y = 0; y < 5; y++) {
+        for (int x = 0; x < 5; x++) {
+            sumidouro += getIndex(x, y);
+        }
+    }
+}
+
+static void rodar_geometria_32x32(void) {
+    for (int y = 0; y < 32; y++) {
+        for (int x = 0; x < 32; x++) {
+            sumidouro += npGeometryIndex(&geo_32x32, x, y);
+        }
+    }
+}
+
+static void rodar_display_digit(void) {
+    for (int d = 0; d < 5; d++) {
+        npDisplayDigit(d);
+    }
+}
+
+static void rodar_encode_16x16(void) {
+    npColorEncode(pixels_16x16, palavras_16x16, dither_16x16, count_of(pixels_16x16));
+    bench_bytes += sizeof(pixels_16x16); // Três bytes por LED no fio, como npDriverStart
+}
+
+static void rodar_faixa_adc(void) {
+    for (uint16_t adc = 0; adc < 4096; adc += 16) {
+        sumidouro += faixa_adc(adc);
+    }
+}
+
+static void rodar_calcular_distancia(void) {
+    for (uint16_t adc = 0; adc < 4096; adc += 256) {
+        sim_set_adc(adc);
+        sumidouro += (int)CalcularDistancia();
+    }
+}
+
+static void rodar_calcular_tempo(void) {
+    for (uint16_t adc = 0; adc < 4096; adc += 256) {
+        sim_set_adc(adc);
+        sumidouro += (int)CalcularTempo();
+    }
+}
+
+static const caso_t casos[] = {
+    { "ssd1306_set_pixel", 128 * 64, rodar_set_pixel },
+    { "ssd1306_draw_line", BENCH_LINHAS, rodar_draw_line },
+    { "ssd1306_draw_string", count_of(textos), rodar_draw_string },
+    { "render_area_total", 1, rodar_render_total },
+    { "render_area_parcial", 1, rodar_render_parcial },
+    { "quadro_oled", 1, rodar_quadro_oled },
+    { "getIndex", 25, rodar_get_index },
+    { "npGeometryIndex_32x32", 32 * 32, rodar_geometria_32x32 },
+    { "npDisplayDigit", 5, rodar_display_digit },
+    { "npColorEncode_16x16", 1, rodar_encode_16x16 },
+    { "faixa_adc", 4096 / 16, rodar_faixa_adc },
+    { "CalcularDistancia", 4096 / 256, rodar_calcular_distancia },
+    { "CalcularTempo", 4096 / 256, rodar_calcular_tempo },
+};
+
+static uint64_t agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t cronometrar(const caso_t *c, uint64_t repeticoes) {
+    uint64_t inicio = agora_ns();
+    for (uint64_t i = 0; i < repeticoes; i++) {
+        c->rodar();
+    }
+    return agora_ns() - inicio;
+}
+
+static void preparar(void) {
+    ssd1306_init_bm(&oled, 128, 64, false, 0x3C, i2c1);
+    npInit();
+    rota_ativar(); // Flash simulada vazia: linha padrão
+    uint32_t s = 12345;
+    for (int i = 0; i < BENCH_LINHAS; i++) {
+        for (int k = 0; k < 4; k++) {
+            s = s * 1103515245u + 12345u;
+            linhas[i][k] = (int)((s >> 16) % (k % 2 ? 64 : 128));
+        }
+    }
+    for (unsigned i = 0; i < sizeof(pixels_16x16); i++) {
+        ((uint8_t *)pixels_16x16)[i] = (uint8_t)(i * 37);
+    }
+}
+
+// Calibra as repetições para uma rodada mínima e guarda a rodada mais rápida
+static void medir(const caso_t *c, resultado_t *r) {
+    c->rodar(); // Aquece caches e preditores
+    uint64_t antes = bench_bytes;
+    c->rodar();
+    r->bytes_op = (double)(bench_bytes - antes) / c->ops;
+
+    uint64_t repeticoes = 1;
+    uint64_t ns;
+    while ((ns = cronometrar(c, repeticoes)) < BENCH_RODADA_NS / 8) {
+        repeticoes *= 2;
+    }
+    repeticoes = repeticoes * BENCH_RODADA_NS / (ns ? ns : 1) + 1;
+
+    uint64_t melhor = UINT64_MAX;
+    for (int i = 0; i < BENCH_RODADAS; i++) {
+        ns = cronometrar(c, repeticoes);
+        if (ns < melhor) {
+            melhor = ns;
+        }
+    }
+    snprintf(r->nome, sizeof(r->nome), "%s", c->nome);
+    r->ns_op = (double)melhor / ((double)repeticoes * c->ops);
+}
+
+static void escrever_json(FILE *f, const resultado_t *r, size_t n) {
+    fprintf(f, "{\n  \"casos\": [\n");
+    for (size_t i = 0; i < n; i++) {
+        fprintf(f, "    {\"nome\": \"%s\", \"ns_op\": %.3f, \"bytes_op\": %.3f}%s\n",
+                r[i].nome, r[i].ns_op, r[i].bytes_op, i + 1 < n ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+// Lê uma linha de base no formato de escrever_json (um caso por linha)
+static size_t ler_base(const char *caminho, resultado_t *base, size_t max) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        perror(caminho);
+        exit(2);
+    }
+    char linha[256];
+    size_t n = 0;
+    while (n < max && fgets(linha, sizeof(linha), f)) {
+        resultado_t *r = &base[n];
+        if (sscanf(linha, " {\"nome\": \"%47[^\"]\", \"ns_op\": %lf, \"bytes_op\": %lf", r->nome, &r->ns_op, &r->bytes_op) == 3) {
+            n++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+static const resultado_t *procurar(const resultado_t *base, size_t n, const char *nome) {
+    for (size_t i = 0; i < n; i++) {
+        if (strcmp(base[i].nome, nome) == 0) {
+            return &base[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    bool json = false;
+    const char *base_arquivo = NULL;
+    const char *gravar_arquivo = NULL;
+    double tolerancia = BENCH_TOLERANCIA;
+    bool apenas_bytes = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--base") == 0 && i + 1 < argc) {
+            base_arquivo = argv[++i];
+        } else if (strcmp(argv[i], "--tolerancia") == 0 && i + 1 < argc) {
+            tolerancia = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--apenas-bytes") == 0) {
+            apenas_bytes = true;
+        } else if (strcmp(argv[i], "--gravar") == 0 && i + 1 < argc) {
+            gravar_arquivo = argv[++i];
+        } else {
+            fprintf(stderr, "uso: %s [--json] [--base arquivo] [--tolerancia pct] [--apenas-bytes] [--gravar arquivo]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    resultado_t base[BENCH_MAX_CASOS];
+    size_t n_base = base_arquivo ? ler_base(base_arquivo, base, BENCH_MAX_CASOS) : 0;
+
+    preparar();
+    resultado_t res[count_of(casos)];
+    for (size_t i = 0; i < count_of(casos); i++) {
+        medir(&casos[i], &res[i]);
+    }
+
+    // Relatório de texto na saída padrão, ou em stderr quando a saída é JSON
+    FILE *rel = json ? stderr : stdout;
+    int regressoes = 0;
+    fprintf(rel, "%-24s %12s %10s", "caso", "ns/op", "bytes/op");
+    fprintf(rel, base_arquivo ? " %12s %8s\n" : "\n", "base ns/op", "");
+    for (size_t i = 0; i < count_of(casos); i++) {
+        fprintf(rel, "%-24s %12.2f %10.2f", res[i].nome, res[i].ns_op, res[i].bytes_op);
+        if (!base_arquivo) {
+            fputc('\n', rel);
+            continue;
+        }
+        const resultado_t *b = procurar(base, n_base, res[i].nome);
+        if (!b) {
+            fprintf(rel, " %12s %8s\n", "-", "novo");
+            continue;
+        }
+        bool lento = !apenas_bytes && res[i].ns_op > b->ns_op * (1.0 + tolerancia / 100.0);
+        bool mais_bytes = res[i].bytes_op > b->bytes_op + 0.005;
+        if (lento || mais_bytes) {
+            regressoes++;
+        }
+        fprintf(rel, " %12.2f %8s\n", b->ns_op, lento ? "LENTO" : mais_bytes ? "BYTES" : "ok");
+    }
+    if (base_arquivo) {
+        if (apenas_bytes) {
+            fprintf(rel, "%d regressoes (apenas bytes/op)\n", regressoes);
+        } else {
+            fprintf(rel, "%d regressoes (tolerancia %.0f%%)\n", regressoes, tolerancia);
+        }
+    }
+
+    if (json) {
+        escrever_json(stdout, res, count_of(casos));
+    }
+    if (gravar_arquivo) {
+        FILE *f = fopen(gravar_arquivo, "w");
+        if (!f) {
+            perror(gravar_arquivo);
+            return 2;
+        }
+        escrever_json(f, res, count_of(casos));
+        fclose(f);
+    }
+    return regressoes ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+// Transportes nulos do benchmark: o SSD1306 usa o driver real (inc/ssd1306_i2c.c)
+// sobre um I2C que só conta os bytes, e as fitas WS2812B contam o quadro entregue.
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "inc/np_driver.h"
+#include "sim.h"
+
+uint64_t bench_bytes = 0;           // Bytes gerados desde o início da medição
+
+static i2c_hw_t bench_i2c_hw = { .raw_intr_stat = I2C_IC_RAW_INTR_STAT_STOP_DET_BITS };
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    (void)i2c;
+    return &bench_i2c_hw;
+}
+
+size_t i2c_get_write_available(i2c_inst_t *i2c) {
+    (void)i2c;
+    return 16;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c;
+    (void)addr;
+    (void)src;
+    (void)nostop;
+    bench_bytes += len;
+    return (int)len;
+}
+
+bool npDriverInit(np_driver_t *drv, const uint *pins, uint n_strips, const uint32_t *words, uint led_count) {
+    (void)pins;
+    drv->n_strips = n_strips;
+    drv->led_count = led_count;
+    drv->words = words;
+    return true;
+}
+
+bool npDriverBusy(const np_driver_t *drv) {
+    (void)drv;
+    return false;
+}
+
+void npDriverWait(const np_driver_t *drv) {
+    (void)drv;
+}
+
+// Três bytes GRB por LED vão ao fio
+void npDriverStart(np_driver_t *drv) {
+    bench_bytes += (uint64_t)drv->led_count * 3;
+}
+
+// O firmware nunca roda o laço principal no benchmark
+void sim_idle(void) {}
+void sim_adc_sampled(uint16_t value) { (void)value; }
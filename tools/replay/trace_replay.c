@@ -0,0 +1,407 @@
+// Replay determinístico de traces de entrada gravados no dispositivo (comandos
+// 'r', 'R' e 'd'). A lógica real do firmware roda sobre o SDK simulado, com relógio
+// simulado; os drivers de I2C e PIO são trocados por modelos de tempo de barramento.
+//
+// Uso:
+//   trace_replay <trace>                      replay de um trace (binário ou dump "TRACE <hex>")
+//   trace_replay --gerar <saida> <s> [seed]   gera um trace sintético de carga com <s> segundos
+//
+// Latência entrada->saída: para cada botão ou byte serial, tempo desde a chegada até a
+// mudança visível que ele causou no display (fim da transferência I2C) ou na matriz de
+// LEDs (fim do quadro no fio). Uma mudança é atribuída à entrada consumida por último
+// pelo firmware antes de a saída ser gerada: o botão na interrupção, o byte serial quando
+// a tarefa serial o tira da fila e o joystick numa leitura do ADC com valor novo (este
+// não é medido). Entradas consumidas sem mudança até a próxima, ou sem mudança visível
+// em RESPOSTA_MAX_US, contam como sem resposta.
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inc/trace.h"
+#include "inc/scheduler.h"
+#include "inc/loop_monitor.h"
+#include "inc/np_color.h"
+#include "sim.h"
+
+#define RESPOSTA_MAX_US 1000000    // Janela para atribuir uma saída a uma entrada
+#define DRENAGEM_US 2000000        // Tempo simulado após o último evento
+#define PENDENTES_MAX 256
+#define SERIAL_TAGS 1024           // Bytes seriais em trânsito (fila do SDK simulado + fila do firmware)
+#define GERAR_BUF_BYTES (1u << 20)
+
+extern int firmware_main(void);    // main() do firmware, renomeado na compilação
+extern sched_t sched;              // Escalonador do firmware
+extern loop_monitor_t loop_mon;    // Monitor do loop do firmware (utilização da CPU)
+extern volatile uint32_t serial_lidos; // Bytes já tirados da fila serial pelo firmware
+extern pixel_t leds[];             // Quadro lógico da matriz
+
+// Entrada à espera de uma saída
+typedef struct {
+    uint64_t t;                    // Chegada
+    uint32_t tag;                  // Ordem de chegada (a partir de 1)
+    bool consumida;
+} pendente_t;
+
+// Distribuição de latências de um tipo de saída
+typedef struct {
+    const char *nome;
+    pendente_t pendentes[PENDENTES_MAX];
+    int n_pendentes;
+    uint32_t *amostras;
+    size_t n, cap;
+    uint32_t sem_resposta;
+    uint32_t hash;                 // Conteúdo da última saída, para detectar mudança
+    bool tem_hash;
+} latencia_t;
+
+static latencia_t lat_display = { .nome = "entrada -> display" };
+static latencia_t lat_leds = { .nome = "entrada -> LEDs" };
+
+static trace_reader_t leitor;
+static trace_event_t proximo;
+static bool tem_proximo;
+static bool iniciado;
+static uint64_t base_us;           // Instante simulado do início do trace
+static uint64_t fim_us;
+static uint32_t n_eventos[4];
+static jmp_buf fim_simulacao;
+
+static uint32_t proxima_tag = 1;
+static uint32_t atual;             // Última entrada consumida (0: leitura nova do joystick)
+static uint64_t execucao_atual;    // Execução de tarefa em que ela foi consumida
+static uint32_t serial_tags[SERIAL_TAGS]; // Bytes seriais ainda não consumidos, em ordem
+static uint32_t serial_entregues, serial_consumidos;
+static uint16_t ultimo_adc;
+static bool tem_adc;
+
+static uint32_t fnv1a(const uint8_t *p, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void amostra(latencia_t *l, uint32_t us) {
+    if (l->n == l->cap) {
+        l->cap = l->cap ? l->cap * 2 : 256;
+        l->amostras = realloc(l->amostras, l->cap * sizeof(uint32_t));
+    }
+    l->amostras[l->n++] = us;
+}
+
+// Identifica a execução de tarefa em andamento (0 fora de tarefas)
+static uint64_t execucao(void) {
+    uint8_t estagio = loop_mon.stage;
+    if (estagio >= sched.count) {
+        return 0;
+    }
+    return (uint64_t)(estagio + 1) << 32 | sched.tasks[estagio].runs;
+}
+
+static void marcar_consumida(latencia_t *l, uint32_t tag) {
+    for (int i = 0; i < l->n_pendentes; i++) {
+        if (l->pendentes[i].tag == tag) {
+            l->pendentes[i].consumida = true;
+        }
+    }
+}
+
+static void consumir(uint32_t tag) {
+    marcar_consumida(&lat_display, tag);
+    marcar_consumida(&lat_leds, tag);
+    atual = tag;
+    execucao_atual = execucao();
+}
+
+// Bytes seriais que o firmware tirou da fila desde a última consulta
+static void sincronizar_serial(void) {
+    while (serial_consumidos != serial_lidos && serial_consumidos != serial_entregues) {
+        consumir(serial_tags[serial_consumidos++ % SERIAL_TAGS]);
+    }
+}
+
+// Leitura nova do joystick: as mudanças seguintes são dela, salvo se a mesma execução
+// de tarefa acabou de consumir um comando (ex.: '!' lê o ADC para mostrar a distância)
+void sim_adc_sampled(uint16_t value) {
+    if (tem_adc && value == ultimo_adc) {
+        return;
+    }
+    ultimo_adc = value;
+    tem_adc = true;
+    sincronizar_serial();
+    if (atual != 0 && execucao() == execucao_atual) {
+        return;
+    }
+    atual = 0;
+}
+
+// Saída gerada agora e visível em visible_us: se o conteúdo mudou, responde a entrada
+// consumida por último; as demais consumidas ficaram sem resposta
+static void saida(latencia_t *l, uint32_t hash, uint64_t visible_us) {
+    if (l->tem_hash && hash == l->hash) {
+        return;
+    }
+    l->hash = hash;
+    l->tem_hash = true;
+    sincronizar_serial();
+    int j = 0;
+    for (int i = 0; i < l->n_pendentes; i++) {
+        const pendente_t *p = &l->pendentes[i];
+        if (!p->consumida) {
+            l->pendentes[j++] = *p;
+        } else if (p->tag == atual && visible_us - p->t <= RESPOSTA_MAX_US) {
+            amostra(l, (uint32_t)(visible_us - p->t));
+        } else {
+            l->sem_resposta++;
+        }
+    }
+    l->n_pendentes = j;
+}
+
+static void entrada(latencia_t *l, uint64_t t, uint32_t tag) {
+    // Entradas antigas demais já não podem ser respondidas
+    int j = 0;
+    for (int i = 0; i < l->n_pendentes; i++) {
+        if (t - l->pendentes[i].t > RESPOSTA_MAX_US) {
+            l->sem_resposta++;
+        } else {
+            l->pendentes[j++] = l->pendentes[i];
+        }
+    }
+    l->n_pendentes = j;
+    if (l->n_pendentes < PENDENTES_MAX) {
+        l->pendentes[l->n_pendentes++] = (pendente_t){ .t = t, .tag = tag };
+    }
+}
+
+void sim_display_frame(const void *display, const uint8_t *frame, size_t len, uint64_t visible_us) {
+    (void)display;
+    saida(&lat_display, fnv1a(frame, len), visible_us);
+}
+
+// Compara o quadro lógico (cores e brilho), não as palavras codificadas: os reenvios
+// do dithering mudam as palavras sem mudar o que foi pedido
+void sim_led_frame(const uint32_t *words, size_t count, uint64_t visible_us) {
+    (void)words;
+    uint32_t hash = fnv1a((const uint8_t *)leds, count * sizeof(pixel_t)) ^ npColorGetBrightness();
+    saida(&lat_leds, hash, visible_us);
+}
+
+// Entrega ao firmware os eventos do trace já vencidos
+static void entregar_eventos(void) {
+    while (tem_proximo && base_us + proximo.time_us <= sim_now_us) {
+        uint64_t t = base_us + proximo.time_us;
+        if (proximo.type < 4) {
+            n_eventos[proximo.type]++;
+        }
+        switch (proximo.type) {
+            case TRACE_EV_ADC:
+                sim_set_adc((uint16_t)proximo.value);
+                break;
+            case TRACE_EV_BUTTON:
+                entrada(&lat_display, t, proxima_tag);
+                entrada(&lat_leds, t, proxima_tag);
+                sincronizar_serial();
+                sim_press_button(proximo.value);
+                consumir(proxima_tag++); // A interrupção trata o botão na hora
+                break;
+            case TRACE_EV_SERIAL:
+                entrada(&lat_display, t, proxima_tag);
+                entrada(&lat_leds, t, proxima_tag);
+                serial_tags[serial_entregues++ % SERIAL_TAGS] = proxima_tag++;
+                sim_push_serial((uint8_t)proximo.value); // Consumido quando a tarefa ler a fila
+                break;
+        }
+        tem_proximo = trace_next(&leitor, &proximo);
+        if (!tem_proximo) {
+            fim_us = t + DRENAGEM_US;
+        }
+    }
+}
+
+// Firmware ocioso: salta o relógio para o próximo evento, liberação de tarefa ou temporizador
+void sim_idle(void) {
+    if (!iniciado) {
+        iniciado = true;
+        base_us = sim_now_us; // O trace começa quando o loop principal começa
+        if (!tem_proximo) {
+            fim_us = base_us + DRENAGEM_US;
+        }
+    }
+    if (!tem_proximo && sim_now_us >= fim_us) {
+        longjmp(fim_simulacao, 1);
+    }
+
+    uint64_t proximo_us = sched_next_release(&sched);
+    uint64_t timer_us = sim_next_timer();
+    if (timer_us < proximo_us) {
+        proximo_us = timer_us;
+    }
+    if (tem_proximo && base_us + proximo.time_us < proximo_us) {
+        proximo_us = base_us + proximo.time_us;
+    }
+    if (!tem_proximo && fim_us < proximo_us) {
+        proximo_us = fim_us;
+    }
+    if (proximo_us > sim_now_us) {
+        sim_now_us = proximo_us;
+    }
+
+    entregar_eventos();
+    sim_fire_timers();
+}
+
+static int comparar(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void relatorio_latencia(latencia_t *l) {
+    l->sem_resposta += l->n_pendentes;
+    printf("%-20s amostras %-6zu sem resposta %-5u", l->nome, l->n, l->sem_resposta);
+    if (l->n == 0) {
+        printf("\n");
+        return;
+    }
+    qsort(l->amostras, l->n, sizeof(uint32_t), comparar);
+    printf(" min %u  p50 %u  p90 %u  p99 %u  max %u us\n",
+           l->amostras[0], l->amostras[l->n / 2], l->amostras[l->n * 90 / 100],
+           l->amostras[l->n * 99 / 100], l->amostras[l->n - 1]);
+}
+
+static void relatorio(void) {
+    printf("Eventos: adc %u, botoes %u, serial %u; duracao simulada %.3f s\n",
+           n_eventos[TRACE_EV_ADC], n_eventos[TRACE_EV_BUTTON], n_eventos[TRACE_EV_SERIAL],
+           (sim_now_us - base_us) / 1e6);
+    relatorio_latencia(&lat_display);
+    relatorio_latencia(&lat_leds);
+    printf("Bytes: I2C %llu, LEDs %llu, USB %llu, total %llu\n",
+           (unsigned long long)sim_i2c_bytes, (unsigned long long)sim_led_bytes,
+           (unsigned long long)sim_usb_bytes,
+           (unsigned long long)(sim_i2c_bytes + sim_led_bytes + sim_usb_bytes));
+    uint64_t janela = sim_now_us - loop_mon.window_us;
+    if (janela > 0) {
+        printf("CPU: ociosa %.1f%%, %u despertares (%.1f/s)\n", 100.0 * loop_mon.idle_us / janela,
+               loop_mon.sleeps, loop_mon.sleeps * 1e6 / janela);
+    }
+    printf("tarefa     exec  perdidos  max_us  med_us  atraso_max_us\n");
+    for (uint8_t i = 0; i < sched.count; i++) {
+        const sched_task_t *t = &sched.tasks[i];
+        printf("%-9s %6u %9u %7u %7u %14u\n", t->name, t->runs, t->misses, t->max_us,
+               t->runs ? (uint32_t)(t->total_us / t->runs) : 0, t->max_late_us);
+    }
+}
+
+// Converte um dígito hexadecimal; -1 se inválido
+static int hex(int ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+// Lê um trace binário ou o dump hexadecimal capturado do terminal serial
+static uint8_t *carregar(const char *caminho, size_t *len) {
+    FILE *f = fopen(caminho, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long tamanho = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *dados = malloc(tamanho > 0 ? (size_t)tamanho : 1);
+    size_t n = fread(dados, 1, (size_t)tamanho, f);
+    fclose(f);
+
+    if (n >= 4 && memcmp(dados, TRACE_MAGIC, 4) == 0) {
+        *len = n;
+        return dados;
+    }
+
+    // Dump: apenas linhas "TRACE <hex>"; demais linhas do terminal são ignoradas
+    uint8_t *bin = malloc(n / 2 + 1);
+    size_t m = 0;
+    char *texto = malloc(n + 1);
+    memcpy(texto, dados, n);
+    texto[n] = '\0';
+    for (char *linha = strtok(texto, "\r\n"); linha; linha = strtok(NULL, "\r\n")) {
+        if (strncmp(linha, "TRACE ", 6) != 0) {
+            continue;
+        }
+        const char *p = linha + 6;
+        while (hex(p[0]) >= 0 && hex(p[1]) >= 0) {
+            bin[m++] = (uint8_t)(hex(p[0]) << 4 | hex(p[1]));
+            p += 2;
+        }
+    }
+    free(texto);
+    free(dados);
+    *len = m;
+    return bin;
+}
+
+// Gera um trace sintético: joystick em passeio aleatório, botões e comandos seriais
+static int gerar(const char *caminho, unsigned segundos, unsigned semente) {
+    static const char comandos[] = "01234!#a+-";
+    static const uint8_t botoes[] = {5, 6, 22};
+    uint8_t *buf = malloc(GERAR_BUF_BYTES);
+    trace_t t;
+    trace_init(&t, buf, GERAR_BUF_BYTES);
+    trace_start(&t, 0);
+    srand(semente);
+
+    int adc = 2048;
+    for (uint64_t us = 0; us < (uint64_t)segundos * 1000000; us += 10000) {
+        if (us % 50000 == 0) {
+            int novo = adc + rand() % 129 - 64;
+            novo = novo < 1 ? 1 : (novo > 4095 ? 4095 : novo);
+            if (abs(novo - adc) > 16) {
+                trace_record(&t, us, TRACE_EV_ADC, (uint32_t)novo);
+            }
+            adc = novo;
+        }
+        if (rand() % 200 == 0) {
+            trace_record(&t, us, TRACE_EV_BUTTON, botoes[rand() % 3]);
+        }
+        if (rand() % 100 == 0) {
+            trace_record(&t, us, TRACE_EV_SERIAL, (uint8_t)comandos[rand() % (sizeof(comandos) - 1)]);
+        }
+    }
+
+    FILE *f = fopen(caminho, "wb");
+    if (!f) {
+        perror(caminho);
+        return 1;
+    }
+    fwrite(buf, 1, t.len, f);
+    fclose(f);
+    printf("%s: %u eventos, %zu bytes\n", caminho, t.count, t.len);
+    free(buf);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 4 && strcmp(argv[1], "--gerar") == 0) {
+        return gerar(argv[2], (unsigned)atoi(argv[3]), argc > 4 ? (unsigned)atoi(argv[4]) : 1);
+    }
+    if (argc != 2) {
+        fprintf(stderr, "uso: %s <trace> | --gerar <saida> <segundos> [semente]\n", argv[0]);
+        return 2;
+    }
+
+    size_t len = 0;
+    uint8_t *dados = carregar(argv[1], &len);
+    if (!dados || !trace_reader_init(&leitor, dados, len)) {
+        fprintf(stderr, "%s: trace invalido\n", argv[1]);
+        return 1;
+    }
+    tem_proximo = trace_next(&leitor, &proximo);
+
+    if (setjmp(fim_simulacao) == 0) {
+        firmware_main();
+    }
+    relatorio();
+    free(dados);
+    return 0;
+}
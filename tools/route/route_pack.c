@@ -0,0 +1,90 @@
+// Gera a imagem da tabela de paradas a partir de um CSV, pronta para a carga pela
+// serial (comando 'L' do firmware).
+//
+// Uso:
+//   route_pack <linha.csv> [--bin <saida>]
+//
+// Cada linha do CSV: nome;distancia_m;horario_s;padrao  (linhas com '#' são ignoradas).
+// Sem --bin, escreve "L" seguido da imagem em hexadecimal na saída padrão, para ser
+// enviada ao terminal serial (ex.: route_pack linha.csv > /dev/ttyACM0).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inc/route_table.h"
+
+#define LINHA_HEX 64               // Bytes por linha no texto hexadecimal
+
+int main(int argc, char **argv) {
+    if (argc != 2 && !(argc == 4 && strcmp(argv[2], "--bin") == 0)) {
+        fprintf(stderr, "uso: %s <linha.csv> [--bin <saida>]\n", argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(argv[1], "r");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    static uint8_t imagem[ROUTE_IMAGE_MAX];
+    route_stop_t *paradas = (route_stop_t *)(imagem + sizeof(route_header_t));
+    unsigned n = 0;
+    char texto[256];
+    for (unsigned linha = 1; fgets(texto, sizeof(texto), f); linha++) {
+        if (texto[0] == '#' || strspn(texto, " \t\r\n") == strlen(texto)) {
+            continue;
+        }
+        char nome[64];
+        unsigned long distancia, horario;
+        unsigned padrao;
+        if (sscanf(texto, " %63[^;];%lu;%lu;%u", nome, &distancia, &horario, &padrao) != 4 ||
+            horario > UINT16_MAX || padrao > UINT8_MAX) {
+            fprintf(stderr, "%s:%u: linha invalida\n", argv[1], linha);
+            return 1;
+        }
+        if (n == ROUTE_MAX_STOPS) {
+            fprintf(stderr, "%s: mais de %u paradas\n", argv[1], (unsigned)ROUTE_MAX_STOPS);
+            return 1;
+        }
+        if (strlen(nome) > ROUTE_NAME_LEN) {
+            fprintf(stderr, "%s:%u: nome truncado em %d caracteres\n", argv[1], linha, ROUTE_NAME_LEN);
+        }
+        route_stop_t *p = &paradas[n++];
+        memset(p, 0, sizeof(*p));
+        size_t tamanho = strlen(nome);
+        memcpy(p->name, nome, tamanho < ROUTE_NAME_LEN ? tamanho : ROUTE_NAME_LEN); // Sem '\0' com 16 caracteres
+        p->distance_m = (uint32_t)distancia;
+        p->offset_s = (uint16_t)horario;
+        p->glyph = (uint8_t)padrao;
+    }
+    fclose(f);
+
+    route_t rota;
+    if (!route_use(&rota, paradas, (uint16_t)n)) {
+        fprintf(stderr, "%s: tabela vazia ou fora de ordem (distancia e horario devem crescer)\n", argv[1]);
+        return 1;
+    }
+    route_header_t h = {
+        .magic = ROUTE_MAGIC,
+        .version = ROUTE_VERSION,
+        .count = (uint16_t)n,
+        .crc = route_crc32((const uint8_t *)paradas, n * sizeof(route_stop_t))
+    };
+    memcpy(imagem, &h, sizeof(h));
+    size_t len = route_image_len((uint16_t)n);
+
+    if (argc == 4) {
+        FILE *out = fopen(argv[3], "wb");
+        if (!out || fwrite(imagem, 1, len, out) != len) {
+            perror(argv[3]);
+            return 1;
+        }
+        fclose(out);
+    } else {
+        printf("L\n");
+        for (size_t i = 0; i < len; i++) {
+            printf("%02x%s", imagem[i], (i + 1) % LINHA_HEX == 0 || i + 1 == len ? "\n" : "");
+        }
+    }
+    fprintf(stderr, "%u paradas, %zu bytes, %lu m\n", n, len, (unsigned long)route_length_m(&rota));
+    return 0;
+}
@@ -0,0 +1,10 @@
+#ifndef sim_hardware_adc_h
+#define sim_hardware_adc_h
+#include "pico/stdlib.h"
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+#endif
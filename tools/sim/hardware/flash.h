@@ -0,0 +1,17 @@
+// Flash simulada: um vetor em RAM mapeado no endereço XIP
+#ifndef sim_hardware_flash_h
+#define sim_hardware_flash_h
+
+#include "pico/stdlib.h"
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define PICO_FLASH_SIZE_BYTES (64u * 1024) // Só os últimos setores são usados pelo firmware
+
+extern uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)sim_flash)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif
@@ -0,0 +1,4 @@
+#ifndef sim_hardware_gpio_h
+#define sim_hardware_gpio_h
+#include "pico/stdlib.h"
+#endif
@@ -0,0 +1,31 @@
+#ifndef sim_hardware_i2c_h
+#define sim_hardware_i2c_h
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst { int index; } i2c_inst_t;
+extern i2c_inst_t *i2c0;
+extern i2c_inst_t *i2c1;
+
+// Registros usados pelo envio intercalado de ssd1306_send_data_multi
+typedef struct {
+    volatile uint32_t enable;
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t clr_stop_det;
+} i2c_hw_t;
+
+#define I2C_IC_ENABLE_ABORT_BITS 0x00000002u
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS 0x00000200u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+
+// Transporte real do SSD1306; implementado pelo binário que o compila (bench)
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+size_t i2c_get_write_available(i2c_inst_t *i2c);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif
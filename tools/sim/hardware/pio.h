@@ -0,0 +1,8 @@
+#ifndef sim_hardware_pio_h
+#define sim_hardware_pio_h
+#include "pico/stdlib.h"
+
+typedef struct pio_hw { volatile uint32_t txf[4]; } pio_hw_t;
+typedef pio_hw_t *PIO;
+
+#endif
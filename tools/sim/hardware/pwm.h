@@ -0,0 +1,14 @@
+#ifndef sim_hardware_pwm_h
+#define sim_hardware_pwm_h
+#include "pico/stdlib.h"
+
+typedef struct { uint32_t csr, div, top; } pwm_config;
+
+uint pwm_gpio_to_slice_num(uint gpio);
+pwm_config pwm_get_default_config(void);
+void pwm_config_set_clkdiv(pwm_config *c, float div);
+void pwm_init(uint slice_num, pwm_config *c, bool start);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+void pwm_set_enabled(uint slice_num, bool enabled);
+
+#endif
@@ -0,0 +1,4 @@
+#ifndef sim_hardware_sync_h
+#define sim_hardware_sync_h
+#include "pico/stdlib.h"
+#endif
@@ -0,0 +1,21 @@
+// Watchdog simulado: os registradores de rascunho existem, mas nunca há reset
+#ifndef sim_hardware_watchdog_h
+#define sim_hardware_watchdog_h
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint32_t ctrl;
+    uint32_t load;
+    uint32_t reason;
+    uint32_t scratch[8];
+    uint32_t tick;
+} watchdog_hw_t;
+
+extern watchdog_hw_t *watchdog_hw;
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_update(void);
+bool watchdog_enable_caused_reboot(void);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef sim_pico_binary_info_h
+#define sim_pico_binary_info_h
+
+#define bi_decl(...)
+
+#endif
@@ -0,0 +1,75 @@
+// SDK do Pico simulado para rodar a lógica do firmware no host sob um relógio
+// simulado. Declara apenas o que o firmware usa; a implementação está em sim_sdk.c.
+#ifndef sim_pico_stdlib_h
+#define sim_pico_stdlib_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <assert.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define PICO_ERROR_TIMEOUT -1
+#define PICO_ERROR_GENERIC -1
+
+#define GPIO_IN 0
+#define GPIO_OUT 1
+#define GPIO_FUNC_I2C 3
+#define GPIO_FUNC_PWM 4
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define IO_IRQ_BANK0 13
+
+// Saída do firmware vai para o contador de bytes da USB simulada
+int sim_printf(const char *fmt, ...);
+#define printf sim_printf
+int sim_vprintf(const char *fmt, va_list args);
+#define vprintf sim_vprintf
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t events);
+
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+struct repeating_timer {
+    int64_t delay_us;
+    repeating_timer_callback_t callback;
+    void *user_data;
+};
+
+void stdio_init_all(void);
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void busy_wait_us(uint64_t us);
+void tight_loop_contents(void);
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+absolute_time_t from_us_since_boot(uint64_t us);
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param);
+void panic(const char *fmt, ...);
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out);
+
+int getchar_timeout_us(uint32_t timeout_us);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_pull_up(uint gpio);
+void gpio_set_function(uint gpio, int fn);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_callback(gpio_irq_callback_t callback);
+void irq_set_enabled(uint num, bool enabled);
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+#endif
@@ -0,0 +1,33 @@
+// Interface interna da simulação: relógio, entradas e saídas observadas.
+#ifndef sim_h
+#define sim_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+extern uint64_t sim_now_us;          // Relógio simulado
+
+// Contadores de bytes por barramento
+extern uint64_t sim_i2c_bytes;
+extern uint64_t sim_led_bytes;
+extern uint64_t sim_usb_bytes;
+
+void sim_advance(uint64_t us);       // Avança o relógio (custo de barramento, sleeps)
+void sim_idle(void);                 // Firmware ocioso: avança até o próximo evento
+
+// Entradas injetadas pelo replay
+void sim_set_adc(uint16_t value);
+void sim_push_serial(uint8_t byte);
+void sim_press_button(unsigned gpio_pin);
+void sim_fire_timers(void);
+uint64_t sim_next_timer(void);
+
+// Saídas observadas, com o instante em que ficaram visíveis
+void sim_display_frame(const void *display, const uint8_t *frame, size_t len, uint64_t visible_us);
+void sim_led_frame(const uint32_t *words, size_t count, uint64_t visible_us);
+
+// Entrada consumida pelo firmware: leitura do joystick
+void sim_adc_sampled(uint16_t value);
+
+#endif
@@ -0,0 +1,130 @@
+// Drivers simulados: substituem o transporte I2C do SSD1306 e o driver PIO/DMA
+// das fitas WS2812B, contabilizando bytes e tempo de barramento no relógio simulado.
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "inc/ssd1306.h"
+#include "inc/np_driver.h"
+#include "sim.h"
+
+// I2C a 400 kHz: 9 bits por byte (8 + ACK) e ~1 byte de START/endereço/STOP por transação
+#define SIM_I2C_HZ (ssd1306_i2c_clock * 1000)
+#define SIM_I2C_BYTE_US (9.0 * 1000000.0 / SIM_I2C_HZ)
+
+// Custo de uma transação de n bytes de dados
+static uint64_t sim_i2c_cost(size_t n) {
+    sim_i2c_bytes += n + 1; // +1: byte de endereço
+    return (uint64_t)((n + 2) * SIM_I2C_BYTE_US + 0.5);
+}
+
+void calculate_render_area_buffer_length(struct render_area *area) {
+    area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
+}
+
+void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+    (void)ssd;
+    (void)command;
+    sim_advance(sim_i2c_cost(2));
+}
+
+void ssd1306_send_command_list(ssd1306_t *ssd, const uint8_t *commands, int number) {
+    (void)ssd;
+    (void)commands;
+    sim_advance(sim_i2c_cost((size_t)number + 1));
+}
+
+void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+    ssd->width = width;
+    ssd->height = height;
+    ssd->pages = height / 8U;
+    ssd->address = address;
+    ssd->i2c_port = i2c;
+    ssd->external_vcc = external_vcc;
+    ssd->bufsize = ssd->pages * ssd->width + 1;
+    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+    ssd->ram_buffer[0] = 0x40;
+    ssd->port_buffer[0] = 0x80;
+}
+
+void ssd1306_config(ssd1306_t *ssd) {
+    ssd1306_send_command_list(ssd, NULL, 25);
+}
+
+void ssd1306_scroll(ssd1306_t *ssd, bool set) {
+    (void)set;
+    ssd1306_send_command_list(ssd, NULL, 8);
+}
+
+void ssd1306_send_data(ssd1306_t *ssd) {
+    ssd1306_send_command_list(ssd, NULL, 6);
+    sim_advance(sim_i2c_cost(ssd->bufsize));
+    sim_display_frame(ssd, ssd->ram_buffer + 1, ssd->bufsize - 1, sim_now_us);
+}
+
+// Janelas em sequência; quadros em paralelo entre barramentos, em série no mesmo barramento
+int ssd1306_send_data_multi(ssd1306_t *displays[], int count) {
+    uint64_t bus_us[2] = {0, 0};
+    uint64_t done_us[ssd1306_max_displays];
+    if (count > ssd1306_max_displays) {
+        count = ssd1306_max_displays;
+    }
+    for (int d = 0; d < count; d++) {
+        ssd1306_send_command_list(displays[d], NULL, 6);
+    }
+    uint64_t start = sim_now_us;
+    for (int d = 0; d < count; d++) {
+        int bus = displays[d]->i2c_port->index & 1;
+        bus_us[bus] += sim_i2c_cost(displays[d]->bufsize);
+        done_us[d] = start + bus_us[bus];
+    }
+    sim_advance(bus_us[0] > bus_us[1] ? bus_us[0] : bus_us[1]);
+    for (int d = 0; d < count; d++) {
+        sim_display_frame(displays[d], displays[d]->ram_buffer + 1, displays[d]->bufsize - 1, done_us[d]);
+    }
+    return count;
+}
+
+void render_on_display(ssd1306_t *ssd, struct render_area *area) {
+    calculate_render_area_buffer_length(area);
+    ssd1306_send_command_list(ssd, NULL, 6);
+    sim_advance(sim_i2c_cost((size_t)area->buffer_length + 1));
+    sim_display_frame(ssd, ssd->ram_buffer + 1, ssd->bufsize - 1, sim_now_us);
+}
+
+void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
+    memcpy(ssd->ram_buffer + 1, bitmap, ssd->bufsize - 1);
+    ssd1306_send_data(ssd);
+}
+
+bool npDriverInit(np_driver_t *drv, const uint *pins, uint n_strips, const uint32_t *words, uint led_count) {
+    memset(drv, 0, sizeof(*drv));
+    if (n_strips > NP_MAX_STRIPS) {
+        n_strips = NP_MAX_STRIPS;
+    }
+    drv->n_strips = n_strips;
+    drv->led_count = led_count;
+    drv->words = words;
+    drv->longest = (led_count + n_strips - 1) / n_strips;
+    for (uint s = 0; s < n_strips; s++) {
+        drv->strips[s].pin = pins[s];
+    }
+    return true;
+}
+
+bool npDriverBusy(const np_driver_t *drv) {
+    return sim_now_us < drv->free_at;
+}
+
+void npDriverWait(const np_driver_t *drv) {
+    if (sim_now_us < drv->free_at) {
+        sim_advance(drv->free_at - sim_now_us);
+    }
+}
+
+// O DMA não consome CPU: o quadro fica visível ao fim da maior fita
+void npDriverStart(np_driver_t *drv) {
+    uint64_t visible = sim_now_us + (uint64_t)drv->longest * NP_LED_US;
+    drv->free_at = visible + NP_RESET_US;
+    sim_led_bytes += (uint64_t)drv->led_count * 3;
+    sim_led_frame(drv->words, drv->led_count, visible);
+}
@@ -0,0 +1,236 @@
+// Implementação do SDK do Pico simulado: relógio, GPIO, ADC, PWM, serial e temporizadores.
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+#include "hardware/watchdog.h"
+#include "hardware/flash.h"
+#include "tusb.h"
+#include "sim.h"
+
+#define SIM_MAX_TIMERS 4
+#define SIM_RX_BYTES 256
+
+uint64_t sim_now_us = 0;
+uint64_t sim_i2c_bytes = 0;
+uint64_t sim_led_bytes = 0;
+uint64_t sim_usb_bytes = 0;
+
+static struct i2c_inst sim_i2c[2] = {{0}, {1}};
+i2c_inst_t *i2c0 = &sim_i2c[0];
+i2c_inst_t *i2c1 = &sim_i2c[1];
+
+static uint16_t adc_value = 2048;    // Joystick centralizado até o primeiro evento
+static uint adc_input = 0;
+static bool gpio_state[32];
+static gpio_irq_callback_t gpio_callback;
+static void (*chars_callback)(void *);
+static void *chars_param;
+static uint8_t rx_queue[SIM_RX_BYTES];
+static size_t rx_head, rx_tail;
+
+static struct {
+    repeating_timer_t *timer;
+    uint64_t next_us;
+    uint64_t period_us;
+} timers[SIM_MAX_TIMERS];
+static int timer_count;
+
+void sim_advance(uint64_t us) {
+    sim_now_us += us;
+}
+
+void sim_set_adc(uint16_t value) {
+    adc_value = value;
+}
+
+void sim_push_serial(uint8_t byte) {
+    size_t next = (rx_head + 1) % SIM_RX_BYTES;
+    if (next != rx_tail) {
+        rx_queue[rx_head] = byte;
+        rx_head = next;
+    }
+    if (chars_callback) {
+        chars_callback(chars_param); // Como a interrupção de recepção da USB
+    }
+}
+
+// Entrega a borda de descida ao callback de interrupção do firmware
+void sim_press_button(unsigned gpio_pin) {
+    if (gpio_callback) {
+        gpio_callback(gpio_pin, GPIO_IRQ_EDGE_FALL);
+    }
+}
+
+// Próximo disparo entre os temporizadores repetitivos
+uint64_t sim_next_timer(void) {
+    uint64_t next = UINT64_MAX;
+    for (int i = 0; i < timer_count; i++) {
+        if (timers[i].timer && timers[i].next_us < next) {
+            next = timers[i].next_us;
+        }
+    }
+    return next;
+}
+
+// Executa os callbacks de temporizador vencidos
+void sim_fire_timers(void) {
+    for (int i = 0; i < timer_count; i++) {
+        while (timers[i].timer && timers[i].next_us <= sim_now_us) {
+            timers[i].next_us += timers[i].period_us;
+            if (!timers[i].timer->callback(timers[i].timer)) {
+                timers[i].timer = NULL;
+            }
+        }
+    }
+}
+
+int sim_printf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+    if (n > 0) {
+        sim_usb_bytes += (uint64_t)n;
+    }
+    return n;
+}
+
+int sim_vprintf(const char *fmt, va_list args) {
+    int n = vsnprintf(NULL, 0, fmt, args);
+    if (n > 0) {
+        sim_usb_bytes += (uint64_t)n;
+    }
+    return n;
+}
+
+uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    memset(&sim_flash[flash_offs], 0xFF, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    memcpy(&sim_flash[flash_offs], data, count);
+}
+
+static watchdog_hw_t sim_watchdog;
+watchdog_hw_t *watchdog_hw = &sim_watchdog;
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug) { (void)delay_ms; (void)pause_on_debug; }
+void watchdog_update(void) {}
+bool watchdog_enable_caused_reboot(void) { return false; }
+
+bool tud_cdc_connected(void) { return true; }
+uint32_t tud_cdc_write_available(void) { return SIM_CDC_FIFO; }
+uint32_t tud_cdc_write_flush(void) { return 0; }
+
+uint32_t tud_cdc_write(const void *buf, uint32_t n) {
+    (void)buf;
+    sim_usb_bytes += n;
+    return n;
+}
+
+void stdio_init_all(void) {}
+void sleep_ms(uint32_t ms) { sim_advance((uint64_t)ms * 1000); }
+void sleep_us(uint64_t us) { sim_advance(us); }
+void busy_wait_us(uint64_t us) { sim_advance(us); }
+void tight_loop_contents(void) { sim_idle(); }
+absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+
+// O sono do firmware termina no próximo evento simulado (entrada, tarefa ou temporizador)
+bool best_effort_wfe_or_timeout(absolute_time_t timeout) {
+    (void)timeout;
+    sim_idle();
+    return sim_now_us >= timeout;
+}
+
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param) {
+    chars_callback = fn;
+    chars_param = param;
+}
+
+void panic(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+uint64_t time_us_64(void) { return sim_now_us; }
+uint32_t time_us_32(void) { return (uint32_t)sim_now_us; }
+absolute_time_t get_absolute_time(void) { return sim_now_us; }
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out) {
+    int i = 0;
+    while (i < timer_count && timers[i].timer) {
+        i++; // Reaproveita a vaga de um temporizador cancelado
+    }
+    if (i >= SIM_MAX_TIMERS) {
+        return false;
+    }
+    uint64_t period = (uint64_t)(delay_us < 0 ? -delay_us : delay_us);
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+    timers[i].timer = out;
+    timers[i].period_us = period;
+    timers[i].next_us = sim_now_us + period;
+    if (i == timer_count) {
+        timer_count++;
+    }
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    if (rx_tail == rx_head) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    uint8_t byte = rx_queue[rx_tail];
+    rx_tail = (rx_tail + 1) % SIM_RX_BYTES;
+    return byte;
+}
+
+void gpio_init(uint gpio) { (void)gpio; }
+void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+void gpio_put(uint gpio, bool value) { gpio_state[gpio & 31] = value; }
+bool gpio_get(uint gpio) { return gpio_state[gpio & 31]; }
+void gpio_pull_up(uint gpio) { (void)gpio; }
+void gpio_set_function(uint gpio, int fn) { (void)gpio; (void)fn; }
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) { (void)gpio; (void)events; (void)enabled; }
+void gpio_set_irq_callback(gpio_irq_callback_t callback) { gpio_callback = callback; }
+void irq_set_enabled(uint num, bool enabled) { (void)num; (void)enabled; }
+
+uint32_t save_and_disable_interrupts(void) { return 0; }
+void restore_interrupts(uint32_t status) { (void)status; }
+
+void adc_init(void) {}
+void adc_gpio_init(uint gpio) { (void)gpio; }
+void adc_select_input(uint input) { adc_input = input; }
+// Leituras do joystick são informadas ao replay, que atribui a elas as mudanças seguintes
+uint16_t adc_read(void) {
+    if (adc_input != 0) {
+        return 2048;
+    }
+    sim_adc_sampled(adc_value);
+    return adc_value;
+}
+
+uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1) & 7; }
+pwm_config pwm_get_default_config(void) { pwm_config c = {0, 16, 0xFFFF}; return c; }
+void pwm_config_set_clkdiv(pwm_config *c, float div) { c->div = (uint32_t)(div * 16); }
+void pwm_init(uint slice_num, pwm_config *c, bool start) { (void)slice_num; (void)c; (void)start; }
+void pwm_set_gpio_level(uint gpio, uint16_t level) { (void)gpio; (void)level; }
+void pwm_set_enabled(uint slice_num, bool enabled) { (void)slice_num; (void)enabled; }
+
+uint32_t clock_get_hz(enum clock_index clk) { (void)clk; return 125000000; }
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) { (void)i2c; return baudrate; }
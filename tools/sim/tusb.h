@@ -0,0 +1,15 @@
+// USB CDC simulada: sempre conectada, bytes escritos vão para sim_usb_bytes
+#ifndef sim_tusb_h
+#define sim_tusb_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIM_CDC_FIFO 256           // Tamanho da FIFO de transmissão do TinyUSB
+
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_cdc_write(const void *buf, uint32_t n);
+uint32_t tud_cdc_write_flush(void);
+
+#endif
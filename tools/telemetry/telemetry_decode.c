@@ -0,0 +1,59 @@
+// Decodificador dos registros binários de telemetria (comando 't' do firmware).
+//
+// Uso:
+//   telemetry_decode [captura]      lê a captura (ou stdin) e escreve CSV na saída padrão
+//
+// Bytes fora de registro (texto anterior ao 't', ruído) são descartados até o
+// próximo sync com CRC válido. Lacunas em seq contam como registros perdidos.
+#include <stdio.h>
+#include <string.h>
+#include "inc/telemetry.h"
+
+int main(int argc, char **argv) {
+    FILE *f = stdin;
+    if (argc > 2) {
+        fprintf(stderr, "uso: %s [captura]\n", argv[0]);
+        return 2;
+    }
+    if (argc == 2 && !(f = fopen(argv[1], "rb"))) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    uint8_t janela[TELEMETRY_RECORD_LEN];
+    size_t n = 0;
+    unsigned long registros = 0, perdidos = 0, descartados = 0;
+    bool tem_seq = false;
+    uint16_t proximo_seq = 0;
+    int ch;
+
+    printf("seq,time_ms,adc_raw,adc_filtered,distance_m,eta_s,flags\n");
+    while ((ch = fgetc(f)) != EOF) {
+        janela[n++] = (uint8_t)ch;
+        if (n < TELEMETRY_RECORD_LEN) {
+            continue;
+        }
+        telemetry_record_t rec;
+        if (!telemetry_decode(janela, &rec)) {
+            // Sem registro válido aqui: avança um byte e tenta de novo
+            memmove(janela, janela + 1, --n);
+            descartados++;
+            continue;
+        }
+        n = 0;
+        if (tem_seq) {
+            perdidos += (uint16_t)(rec.seq - proximo_seq);
+        }
+        tem_seq = true;
+        proximo_seq = (uint16_t)(rec.seq + 1);
+        registros++;
+        printf("%u,%lu,%u,%u,%lu,%u,0x%02x\n", rec.seq, (unsigned long)rec.time_ms, rec.adc_raw,
+               rec.adc_filtered, (unsigned long)rec.distance_m, rec.eta_s, rec.flags);
+    }
+    descartados += n;
+    if (f != stdin) {
+        fclose(f);
+    }
+    fprintf(stderr, "%lu registros, %lu perdidos, %lu bytes descartados\n", registros, perdidos, descartados);
+    return 0;
+}
@@ -0,0 +1,19 @@
+// Verificação mínima para os testes de host: conta falhas e segue executando.
+#ifndef tests_check_h
+#define tests_check_h
+
+#include <stdio.h>
+
+static int check_falhas = 0;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+            check_falhas++; \
+        } \
+    } while (0)
+
+// Resultado do teste para o ctest
+#define CHECK_FIM() (check_falhas ? (fprintf(stderr, "%d falhas\n", check_falhas), 1) : 0)
+
+#endif
@@ -0,0 +1,85 @@
+// Testes do monitor do loop (inc/loop_monitor.c): faixas do histograma, período
+// sem o tempo dormindo, estouros de orçamento e os dois tipos de reinício.
+#include "inc/loop_monitor.h"
+#include "hardware/watchdog.h"
+#include "check.h"
+
+// Watchdog de mentira: só conta as alimentações
+static watchdog_hw_t wd;
+watchdog_hw_t *watchdog_hw = &wd;
+static int alimentacoes;
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug) { (void)delay_ms; (void)pause_on_debug; }
+void watchdog_update(void) { alimentacoes++; }
+bool watchdog_enable_caused_reboot(void) { return false; }
+
+static loop_monitor_t m;
+
+static void teste_faixas(void) {
+    CHECK(loop_monitor_bucket(0) == 0);
+    CHECK(loop_monitor_bucket(1) == 0);
+    CHECK(loop_monitor_bucket(2) == 1);
+    CHECK(loop_monitor_bucket(3) == 1);
+    CHECK(loop_monitor_bucket(4) == 2);
+    CHECK(loop_monitor_bucket(1023) == 9);
+    CHECK(loop_monitor_bucket(1024) == 10);
+    CHECK(loop_monitor_bucket(UINT32_MAX) == LOOP_MON_BUCKETS - 1);
+}
+
+// Um loop que trabalha 100 us e dorme 50 ms entre passagens registra 100 us, não 50 ms
+static void teste_periodo_sem_sono(void) {
+    loop_monitor_init(&m, 1000);
+    loop_monitor_arm_watchdog(&m, 2000);
+    alimentacoes = 0;
+    uint64_t agora = 1000;
+    for (int i = 0; i < 10; i++) {
+        loop_monitor_pass(&m, agora);
+        agora += 100;
+        loop_monitor_idle(&m, 50000, false);
+        agora += 50000;
+    }
+    CHECK(m.period_hist[loop_monitor_bucket(100)] == 9);
+    CHECK(m.period_hist[loop_monitor_bucket(50100)] == 0);
+    CHECK(alimentacoes == 10);
+    CHECK(m.idle_us == 500000 && m.sleeps == 10);
+
+    // Sono registrado além do intervalo medido não gera período negativo
+    loop_monitor_idle(&m, 90000, true);
+    loop_monitor_pass(&m, agora + 10);
+    CHECK(m.period_hist[0] == 1);
+    CHECK(m.low_clock_us == 90000);
+}
+
+static void teste_orcamento_e_reinicio(void) {
+    loop_monitor_init(&m, 1000);
+    loop_monitor_stage_begin(&m, 3);
+    CHECK(m.stage == 3);
+    loop_monitor_stage_end(&m, 3, 20, 400);
+    loop_monitor_stage_begin(&m, 5);
+    loop_monitor_stage_end(&m, 5, 0, 2500);
+    CHECK(m.stage == LOOP_MON_IDLE);
+    CHECK(m.iterations == 2);
+    CHECK(m.worst_us == 2500 && m.worst_stage == 5);
+    CHECK(m.overruns[5] == 1 && m.overruns[3] == 0);
+    CHECK(m.last_overrun_stage == 5 && m.last_overrun_us == 2500);
+    CHECK(m.jitter_hist[loop_monitor_bucket(20)] == 1);
+
+    // 'h' zera histogramas e estouros, mas não a janela de utilização ('u')
+    loop_monitor_reset_idle(&m, 500);
+    loop_monitor_idle(&m, 300, false);
+    loop_monitor_reset_stats(&m);
+    CHECK(m.iterations == 0 && m.overruns[5] == 0 && m.worst_stage == LOOP_MON_NONE);
+    CHECK(m.idle_us == 300 && m.sleeps == 1 && m.window_us == 500);
+
+    // 'u' faz o contrário
+    loop_monitor_stage_end(&m, 1, 0, 10);
+    loop_monitor_reset_idle(&m, 900);
+    CHECK(m.idle_us == 0 && m.sleeps == 0 && m.window_us == 900);
+    CHECK(m.iterations == 1);
+}
+
+int main(void) {
+    teste_faixas();
+    teste_periodo_sem_sono();
+    teste_orcamento_e_reinicio();
+    return CHECK_FIM();
+}
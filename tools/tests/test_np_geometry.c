@@ -0,0 +1,75 @@
+// Testes da geometria da matriz (inc/np_geometry.c).
+#include <string.h>
+#include "inc/np_geometry.h"
+#include "check.h"
+
+// getIndex original do firmware (matriz 5x5 única, fiação em serpentina)
+static int get_index_original(int x, int y) {
+    if (y % 2 == 0) {
+        return 24 - (y * 5 + x);
+    }
+    return 24 - (y * 5 + (4 - x));
+}
+
+// A geometria padrão do firmware (np_geo em neopixel_pio.c) reproduz o mapeamento antigo
+static void teste_padrao(void) {
+    const np_geometry_t geo = {
+        .panel_width = 5,
+        .panel_height = 5,
+        .tiles_x = 1,
+        .tiles_y = 1,
+        .serpentine = true,
+        .tile_serpentine = true,
+        .rotation = NP_ROT_180
+    };
+    for (int y = 0; y < 5; y++) {
+        for (int x = 0; x < 5; x++) {
+            CHECK(npGeometryIndex(&geo, x, y) == get_index_original(x, y));
+        }
+    }
+    CHECK(npGeometryCount(&geo) == 25);
+    CHECK(npGeometryIndex(&geo, -1, 0) == -1);
+    CHECK(npGeometryIndex(&geo, 5, 0) == -1);
+    CHECK(npGeometryIndex(&geo, 0, 5) == -1);
+}
+
+// Painéis encadeados, em qualquer rotação: cada LED da cadeia é usado exatamente uma vez
+// e cada painel ocupa um bloco contíguo
+static void teste_bijecao(void) {
+    static uint8_t usado[2 * 3 * 8 * 8];
+    for (int rot = NP_ROT_0; rot <= NP_ROT_270; rot++) {
+        for (int serp = 0; serp < 2; serp++) {
+            const np_geometry_t geo = {
+                .panel_width = 8,
+                .panel_height = 8,
+                .tiles_x = 2,
+                .tiles_y = 3,
+                .serpentine = serp,
+                .tile_serpentine = true,
+                .rotation = (np_rotation_t)rot
+            };
+            CHECK(npGeometryWidth(&geo) == 16 && npGeometryHeight(&geo) == 24);
+            memset(usado, 0, sizeof(usado));
+            for (int y = 0; y < 24; y++) {
+                for (int x = 0; x < 16; x++) {
+                    int i = npGeometryIndex(&geo, x, y);
+                    CHECK(i >= 0 && i < (int)sizeof(usado));
+                    if (i >= 0 && i < (int)sizeof(usado)) {
+                        usado[i]++;
+                        int painel = (y / 8) % 2 ? 1 - x / 8 : x / 8; // Fileira ímpar invertida
+                        CHECK(i / 64 == (y / 8) * 2 + painel);
+                    }
+                }
+            }
+            for (size_t i = 0; i < sizeof(usado); i++) {
+                CHECK(usado[i] == 1);
+            }
+        }
+    }
+}
+
+int main(void) {
+    teste_padrao();
+    teste_bijecao();
+    return CHECK_FIM();
+}
@@ -0,0 +1,122 @@
+// Testes da tabela de paradas (inc/route_table.c): validação, busca binária,
+// localização na linha e carga página a página.
+#include <string.h>
+#include "inc/route_table.h"
+#include "check.h"
+
+#define PARADAS 150
+
+static uint8_t imagem[ROUTE_IMAGE_MAX];
+static uint8_t flash[ROUTE_IMAGE_MAX];
+static int paginas;
+
+// Linha com trechos de tamanhos diferentes: parada i em i * 1000 + i * i metros
+static size_t montar_imagem(uint16_t count) {
+    route_stop_t *stops = (route_stop_t *)(imagem + sizeof(route_header_t));
+    memset(imagem, 0, sizeof(imagem));
+    for (uint16_t i = 0; i < count; i++) {
+        stops[i].name[0] = 'P';
+        stops[i].distance_m = (uint32_t)i * 1000 + (uint32_t)i * i;
+        stops[i].offset_s = (uint16_t)(i * 60);
+        stops[i].glyph = (uint8_t)(i % 5);
+    }
+    route_header_t h = { ROUTE_MAGIC, ROUTE_VERSION, 0, count, 0 };
+    h.crc = route_crc32((const uint8_t *)stops, (size_t)count * sizeof(route_stop_t));
+    memcpy(imagem, &h, sizeof(h));
+    return route_image_len(count);
+}
+
+static void teste_busca(void) {
+    route_t r;
+    size_t len = montar_imagem(PARADAS);
+    CHECK(route_open(&r, imagem, len));
+    CHECK(r.count == PARADAS);
+    CHECK(route_length_m(&r) == (PARADAS - 1) * 1000 + (PARADAS - 1) * (PARADAS - 1));
+
+    // Busca binária confere com a busca linear em todas as fronteiras de trecho
+    for (uint16_t i = 0; i < PARADAS; i++) {
+        uint32_t d = r.stops[i].distance_m;
+        CHECK(route_find(&r, d) == i);
+        if (d > 0) {
+            CHECK(route_find(&r, d - 1) == i - 1);
+        }
+        CHECK(route_find(&r, d + 1) == i);
+    }
+    CHECK(route_find(&r, UINT32_MAX) == PARADAS - 1);
+
+    // Meio do trecho 10-11 (10100 m a 11121 m): tempo interpolado e arredondado
+    route_position_t pos;
+    route_locate(&r, 10610, &pos);
+    CHECK(pos.prev == 10 && pos.next == 11);
+    CHECK(pos.to_next_m == 511);
+    CHECK(pos.eta_next_s == 30);
+    CHECK(pos.eta_end_s == 30 + (PARADAS - 1 - 11) * 60);
+
+    // Terminal
+    route_locate(&r, route_length_m(&r) + 500, &pos);
+    CHECK(pos.prev == PARADAS - 1 && pos.next == PARADAS - 1);
+    CHECK(pos.to_next_m == 0 && pos.eta_next_s == 0 && pos.eta_end_s == 0);
+}
+
+static void teste_validacao(void) {
+    route_t r;
+    size_t len = montar_imagem(5);
+    CHECK(!route_open(&r, imagem, len - 1)); // Truncada
+    imagem[sizeof(route_header_t) + 3] ^= 1;
+    CHECK(!route_open(&r, imagem, len));     // CRC
+    montar_imagem(5);
+    imagem[4] = ROUTE_VERSION + 1;
+    CHECK(!route_open(&r, imagem, len));     // Versão
+
+    route_stop_t fora_de_ordem[2] = {{ "A", 100, 0, 0, 0 }, { "B", 100, 10, 0, 0 }};
+    CHECK(!route_use(&r, fora_de_ordem, 2));
+    fora_de_ordem[1].distance_m = 200;
+    CHECK(route_use(&r, fora_de_ordem, 2));
+    CHECK(!route_use(&r, fora_de_ordem, 0));
+}
+
+static void gravar(uint32_t offset, const uint8_t *page) {
+    CHECK(offset % ROUTE_PAGE_LEN == 0);
+    CHECK(offset + ROUTE_PAGE_LEN <= sizeof(flash));
+    memcpy(&flash[offset], page, ROUTE_PAGE_LEN);
+    paginas++;
+}
+
+static void teste_carga(void) {
+    size_t len = montar_imagem(PARADAS);
+    route_loader_t l;
+    memset(flash, 0xAA, sizeof(flash));
+    paginas = 0;
+    route_loader_begin(&l, gravar);
+    int estado = ROUTE_LOAD_MORE;
+    for (size_t i = 0; i < len; i++) {
+        CHECK(estado == ROUTE_LOAD_MORE);
+        estado = route_loader_feed(&l, imagem[i]);
+    }
+    CHECK(estado == ROUTE_LOAD_DONE);
+    CHECK(paginas == (int)((len + ROUTE_PAGE_LEN - 1) / ROUTE_PAGE_LEN));
+    CHECK(memcmp(flash, imagem, len) == 0);
+    CHECK(flash[len] == 0xFF); // Última página completada com 0xFF
+    CHECK(route_loader_feed(&l, 0) == ROUTE_LOAD_DONE);
+
+    route_t r;
+    CHECK(route_open(&r, flash, sizeof(flash)));
+    CHECK(r.count == PARADAS);
+
+    // Cabeçalho inválido é rejeitado assim que chega, antes de gravar qualquer página
+    paginas = 0;
+    route_loader_begin(&l, gravar);
+    imagem[0] ^= 0xFF;
+    for (size_t i = 0; i < sizeof(route_header_t) - 1; i++) {
+        CHECK(route_loader_feed(&l, imagem[i]) == ROUTE_LOAD_MORE);
+    }
+    CHECK(route_loader_feed(&l, imagem[sizeof(route_header_t) - 1]) == ROUTE_LOAD_ERROR);
+    CHECK(paginas == 0);
+}
+
+int main(void) {
+    teste_busca();
+    teste_validacao();
+    teste_carga();
+    return CHECK_FIM();
+}
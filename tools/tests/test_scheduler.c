@@ -0,0 +1,138 @@
+// Testes do escalonador cooperativo (inc/scheduler.c) sob relógio controlado.
+#include "inc/scheduler.h"
+#include "check.h"
+
+static uint64_t relogio;
+static uint64_t agora(void) { return relogio; }
+
+static sched_t s;
+static uint8_t tarefa;
+static int execucoes;
+static int restantes;             // Quantas vezes a tarefa ainda se redispara
+
+// Como a tarefa serial: um item por execução e redisparo enquanto houver fila
+static void consumir(void *arg) {
+    (void)arg;
+    execucoes++;
+    relogio += 10;
+    if (restantes > 0) {
+        restantes--;
+        sched_trigger(&s, tarefa, 0);
+    }
+}
+
+static void teste_redisparo_periodica(void) {
+    relogio = 0;
+    execucoes = 0;
+    restantes = 4;
+    sched_init(&s, agora);
+    tarefa = sched_add_periodic(&s, "serial", consumir, NULL, 100000, 100000, 1);
+
+    // Cinco itens enfileirados são consumidos sem esperar o período
+    for (int i = 0; i < 5; i++) {
+        CHECK(sched_run_once(&s));
+    }
+    CHECK(execucoes == 5);
+    CHECK(relogio == 50);
+
+    // Sem redisparo, volta à grade do período
+    CHECK(!sched_run_once(&s));
+    CHECK(s.tasks[tarefa].release_us == 40 + 100000);
+}
+
+static void teste_periodo_sem_redisparo(void) {
+    relogio = 0;
+    execucoes = 0;
+    restantes = 0;
+    sched_init(&s, agora);
+    tarefa = sched_add_periodic(&s, "serial", consumir, NULL, 100000, 100000, 1);
+    CHECK(sched_run_once(&s));
+    CHECK(s.tasks[tarefa].release_us == 100000);
+    CHECK(!sched_run_once(&s));
+    relogio = 100000;
+    CHECK(sched_run_once(&s));
+    CHECK(execucoes == 2);
+}
+
+// Registra a ordem em que as tarefas rodaram
+static char ordem[16];
+static int n_ordem;
+
+static void anotar(void *arg) {
+    ordem[n_ordem++] = *(const char *)arg;
+    relogio += 5;
+}
+
+static void teste_ordem(void) {
+    static const char a = 'a', b = 'b', c = 'c', d = 'd';
+    relogio = 1000;
+    n_ordem = 0;
+    sched_init(&s, agora);
+    uint8_t ta = sched_add_oneshot(&s, "a", anotar, (void *)&a, 500, 1);
+    uint8_t tb = sched_add_oneshot(&s, "b", anotar, (void *)&b, 100, 1);
+    uint8_t tc = sched_add_oneshot(&s, "c", anotar, (void *)&c, 900, 2);
+    uint8_t td = sched_add_oneshot(&s, "d", anotar, (void *)&d, 10, 3);
+    CHECK(sched_next_release(&s) == UINT64_MAX); // Disparo único começa desarmado
+    sched_trigger(&s, ta, 0);
+    sched_trigger(&s, tb, 0);
+    sched_trigger(&s, tc, 0);
+    sched_trigger(&s, td, 50); // Mais urgente, mas ainda não liberada
+
+    // Maior prioridade primeiro; no empate, o prazo absoluto mais cedo
+    while (sched_run_once(&s)) {
+    }
+    CHECK(n_ordem == 3);
+    CHECK(ordem[0] == 'c' && ordem[1] == 'b' && ordem[2] == 'a');
+    CHECK(sched_next_release(&s) == 1050);
+
+    relogio = 1050;
+    CHECK(sched_run_once(&s));
+    CHECK(ordem[3] == 'd');
+    CHECK(!sched_run_once(&s)); // Disparo único desarmado após rodar
+
+    // Estatísticas: 'a' começou 10 us após a liberação e terminou dentro do prazo
+    CHECK(s.tasks[ta].runs == 1);
+    CHECK(s.tasks[ta].max_late_us == 10);
+    CHECK(s.tasks[ta].misses == 0);
+    CHECK(s.tasks[td].last_us == 5);
+
+    // Prazo de 10 us estourado por uma execução de 5 us iniciada 20 us atrasada
+    sched_trigger(&s, td, 0);
+    relogio += 20;
+    CHECK(sched_run_once(&s));
+    CHECK(s.tasks[td].misses == 1);
+
+    // Cancelada não roda
+    sched_trigger(&s, ta, 0);
+    sched_cancel(&s, ta);
+    CHECK(!sched_run_once(&s));
+    sched_reset_stats(&s);
+    CHECK(s.tasks[td].runs == 0 && s.tasks[td].misses == 0);
+}
+
+// Período alterado vale a partir da próxima liberação; atrasos não acumulam execuções
+static void teste_periodo(void) {
+    relogio = 0;
+    execucoes = 0;
+    restantes = 0;
+    sched_init(&s, agora);
+    tarefa = sched_add_periodic(&s, "p", consumir, NULL, 1000, 1000, 1);
+    CHECK(sched_run_once(&s));
+    sched_set_period(&s, tarefa, 5000);
+    CHECK(s.tasks[tarefa].release_us == 1000);
+    relogio = 1000;
+    CHECK(sched_run_once(&s));
+    CHECK(s.tasks[tarefa].release_us == 6000);
+    relogio = 30000; // Vários períodos perdidos: uma execução só, sem rajada de recuperação
+    CHECK(sched_run_once(&s));
+    CHECK(s.tasks[tarefa].release_us == 30010); // Fim da execução
+    CHECK(execucoes == 3);
+}
+
+int main(void) {
+    teste_redisparo_periodica();
+    teste_periodo_sem_redisparo();
+    teste_ordem();
+    teste_periodo();
+    return CHECK_FIM();
+}
@@ -0,0 +1,106 @@
+// Testes da telemetria binária (inc/telemetry.c): CRC-8, formato do registro,
+// fila circular com volta do índice, perdas e decimação.
+#include <string.h>
+#include "inc/telemetry.h"
+#include "check.h"
+
+static void teste_crc_e_formato(void) {
+    CHECK(telemetry_crc8((const uint8_t *)"123456789", 9) == 0xF4); // Valor de verificação do CRC-8/SMBUS
+
+    telemetry_record_t rec = { 0x1234, 0xA1B2C3D4, 4095, 2048, 100000, 4800, TELEMETRY_FLAG_ALARM }, lido;
+    uint8_t bytes[TELEMETRY_RECORD_LEN];
+    telemetry_encode(&rec, bytes);
+    CHECK(bytes[0] == TELEMETRY_SYNC0 && bytes[1] == TELEMETRY_SYNC1);
+    CHECK(bytes[2] == 0x34 && bytes[3] == 0x12);   // Little-endian
+    CHECK(bytes[4] == 0xD4 && bytes[7] == 0xA1);
+    CHECK(telemetry_decode(bytes, &lido));
+    CHECK(memcmp(&rec, &lido, sizeof(rec)) == 0);
+
+    for (int i = 2; i < TELEMETRY_RECORD_LEN; i++) {
+        bytes[i] ^= 0x10; // Qualquer bit trocado é detectado
+        CHECK(!telemetry_decode(bytes, &lido));
+        bytes[i] ^= 0x10;
+    }
+}
+
+// Retira n bytes da fila, atravessando o fim do buffer se preciso
+static size_t retirar(telemetry_t *t, uint8_t *out, size_t n) {
+    size_t total = 0;
+    const uint8_t *p;
+    size_t k;
+    while (total < n && (k = telemetry_peek(t, &p)) > 0) {
+        if (k > n - total) {
+            k = n - total;
+        }
+        memcpy(out + total, p, k);
+        telemetry_consume(t, k);
+        total += k;
+    }
+    return total;
+}
+
+static void teste_fila(void) {
+    uint8_t buf[64]; // Não é múltiplo de 20: registros atravessam o fim do buffer
+    telemetry_t t;
+    telemetry_init(&t, buf, sizeof(buf), 1, 3);
+    telemetry_record_t rec = {0};
+
+    for (int i = 0; i < 3; i++) {
+        rec.time_ms = (uint32_t)i;
+        CHECK(telemetry_push(&t, &rec));
+    }
+    CHECK(telemetry_pending(&t) == 60);
+    rec.time_ms = 3;
+    CHECK(!telemetry_push(&t, &rec)); // Cheia: descartado
+    CHECK(t.dropped == 1);
+
+    uint8_t bytes[3 * TELEMETRY_RECORD_LEN];
+    telemetry_record_t lido;
+    CHECK(retirar(&t, bytes, 40) == 40);
+    CHECK(telemetry_decode(bytes, &lido) && lido.seq == 0);
+    CHECK(telemetry_decode(bytes + 20, &lido) && lido.seq == 1);
+
+    // Dois registros novos: o segundo dá a volta no buffer
+    for (int i = 4; i < 6; i++) {
+        rec.time_ms = (uint32_t)i;
+        rec.flags = 0;
+        CHECK(telemetry_push(&t, &rec));
+    }
+    const uint8_t *p;
+    CHECK(telemetry_peek(&t, &p) == sizeof(buf) - 40); // Só até o fim do buffer
+    CHECK(retirar(&t, bytes, sizeof(bytes)) == 60);
+    CHECK(telemetry_pending(&t) == 0);
+
+    CHECK(telemetry_decode(bytes, &lido) && lido.seq == 2 && lido.time_ms == 2);
+    CHECK(telemetry_decode(bytes + 20, &lido) && lido.seq == 4 && lido.time_ms == 4);
+    CHECK(lido.flags & TELEMETRY_FLAG_LOSS);        // Lacuna em seq e marca de perda
+    CHECK(telemetry_decode(bytes + 40, &lido) && lido.seq == 5 && lido.time_ms == 5);
+    CHECK(!(lido.flags & TELEMETRY_FLAG_LOSS));
+}
+
+static void teste_decimacao_e_filtro(void) {
+    uint8_t buf[64];
+    telemetry_t t;
+    telemetry_init(&t, buf, sizeof(buf), 4, 3);
+    int devidos = 0;
+    for (int i = 0; i < 20; i++) {
+        devidos += telemetry_due(&t);
+    }
+    CHECK(devidos == 5);
+    telemetry_set_decimation(&t, 0); // 0 vale como 1
+    CHECK(telemetry_due(&t));
+
+    CHECK(telemetry_filter(&t, 1000) == 1000); // Primeira amostra inicializa o filtro
+    uint16_t y = 0;
+    for (int i = 0; i < 100; i++) {
+        y = telemetry_filter(&t, 2000);
+    }
+    CHECK(y == 2000); // Converge sem erro residual
+}
+
+int main(void) {
+    teste_crc_e_formato();
+    teste_fila();
+    teste_decimacao_e_filtro();
+    return CHECK_FIM();
+}
@@ -0,0 +1,81 @@
+// Testes do gravador de traces (inc/trace.c): varints LEB128 nas fronteiras,
+// ida e volta gravação -> leitura, estouro do buffer e validação do cabeçalho.
+#include <string.h>
+#include "inc/trace.h"
+#include "check.h"
+
+static void teste_ida_e_volta(void) {
+    static const uint32_t deltas[] = { 0, 127, 128, 16383, 16384, 2097152, UINT32_MAX };
+    static const uint32_t valores[] = { 0, 0x7F, 0x80, 0x3FFF, 0x4000, 0x0FFFFFFF, UINT32_MAX };
+    static const size_t bytes_delta[] = { 1, 1, 2, 2, 3, 4, 5 };
+    static const size_t bytes_valor[] = { 1, 1, 2, 2, 3, 4, 5 };
+    uint8_t buf[256];
+    trace_t t;
+    trace_init(&t, buf, sizeof(buf));
+    CHECK(!trace_record(&t, 0, TRACE_EV_ADC, 1)); // Inativo até trace_start
+    trace_start(&t, 1000);
+
+    uint64_t agora = 1000;
+    for (size_t i = 0; i < sizeof(deltas) / sizeof(deltas[0]); i++) {
+        size_t antes = t.len;
+        agora += deltas[i];
+        CHECK(trace_record(&t, agora, (uint8_t)(i + 1), valores[i]));
+        CHECK(t.len - antes == bytes_delta[i] + 1 + bytes_valor[i]);
+    }
+    CHECK(t.count == 7);
+
+    trace_reader_t r;
+    trace_event_t ev;
+    CHECK(trace_reader_init(&r, buf, t.len));
+    uint64_t esperado = 0;
+    for (size_t i = 0; i < sizeof(deltas) / sizeof(deltas[0]); i++) {
+        esperado += deltas[i];
+        CHECK(trace_next(&r, &ev));
+        CHECK(ev.time_us == esperado);
+        CHECK(ev.type == i + 1);
+        CHECK(ev.value == valores[i]);
+    }
+    CHECK(!trace_next(&r, &ev));
+
+    // Truncado no meio de um varint: a leitura para sem inventar eventos
+    CHECK(trace_reader_init(&r, buf, t.len - 2));
+    int lidos = 0;
+    while (trace_next(&r, &ev)) {
+        lidos++;
+    }
+    CHECK(lidos == 6);
+}
+
+static void teste_estouro_e_cabecalho(void) {
+    uint8_t buf[TRACE_HEADER_LEN + 3 * TRACE_EVENT_MAX_LEN];
+    trace_t t;
+    trace_init(&t, buf, sizeof(buf));
+    trace_start(&t, 0);
+    // Eventos de tamanho máximo: delta e valor com 5 bytes cada
+    int gravados = 0;
+    uint64_t agora = 0;
+    while (trace_record(&t, agora += 1u << 30, TRACE_EV_SERIAL, UINT32_MAX)) {
+        gravados++;
+    }
+    CHECK(gravados == 3);
+    CHECK(t.overflow && !t.active);
+
+    // Relógio que volta atrás grava delta 0
+    trace_start(&t, 500);
+    CHECK(trace_record(&t, 100, TRACE_EV_BUTTON, 5));
+    trace_reader_t r;
+    trace_event_t ev;
+    CHECK(trace_reader_init(&r, buf, t.len) && trace_next(&r, &ev) && ev.time_us == 0);
+
+    buf[4] = TRACE_VERSION + 1;
+    CHECK(!trace_reader_init(&r, buf, t.len));
+    memcpy(buf, "XTRC", 4);
+    CHECK(!trace_reader_init(&r, buf, t.len));
+    CHECK(!trace_reader_init(&r, buf, TRACE_HEADER_LEN - 1));
+}
+
+int main(void) {
+    teste_ida_e_volta();
+    teste_estouro_e_cabecalho();
+    return CHECK_FIM();
+}